@@ -0,0 +1,460 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Benchmark program for solver kernels.
+ * Build with 'make bench' and run in an empty directory:
+ *   artracfd_bench [-s mx*my*mz] [-r repeats] [-o file]
+ * A case is generated with the given mesh and initialized as the solver
+ * does, then the field is replaced by a smooth synthetic flow and each
+ * kernel is timed for a number of repeats. Results are reported in ns per
+ * unit of work and million units per second, and written to a JSON file.
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include "program_entrance.h"
+#include "case_generator.h"
+#include "preprocess.h"
+#include "initialization.h"
+#include "postprocess.h"
+#include "convective_flux.h"
+#include "diffusive_flux.h"
+#include "weno.h"
+#include "boundary_treatment.h"
+#include "computational_geometry.h"
+#include "fluid_dynamics.h"
+#include "cfd_commons.h"
+#include "timer.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    BENCHN = 8, /* number of benchmarks */
+    REPMAX = 101, /* maximum number of repeats */
+    POOLN = 4096, /* number of samples in a pool of synthetic inputs */
+    PASSN = 64, /* number of passes over a pool */
+} BenchConst;
+typedef struct {
+    const char *name; /* kernel name */
+    const char *unit; /* unit of work */
+    long count; /* units of work in a repeat */
+    Real min; /* ns per unit */
+    Real median;
+    Real stddev;
+} Result;
+typedef long (*Benchmark)(Space *, const Model *);
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ConfigureCase(const IntVec);
+static void SynthesizeField(Space *, const Model *);
+static long BenchFhat(Space *, const Model *);
+static long BenchFvhat(Space *, const Model *);
+static long BenchWENO3(Space *, const Model *);
+static long BenchWENO5(Space *, const Model *);
+static long BenchEigenvector(Space *, const Model *);
+static long BenchBoundary(Space *, const Model *);
+static long BenchPointInPolyhedron(Space *, const Model *);
+static long BenchEvolve(Space *, const Model *);
+static void RunBenchmark(const int, Benchmark, Space *, const Model *, Result *);
+static void WriteResult(const char *, const int, const Result [], const Space *, const Model *);
+static Real Random(void);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static volatile Real sink = 0.0; /* keeps results of timed kernels alive */
+static unsigned long seed = 1; /* state of the random number generator */
+/****************************************************************************
+ * The Main Function
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+    Control control = {
+        .runMode = 's',
+        .proc = {0}};
+    Time time = {0};
+    Space space = {0};
+    Model model = {0};
+    IntVec m = {64, 64, 64}; /* mesh number */
+    int repN = 11; /* number of repeats */
+    const char *fname = "artracfd_bench.json";
+    for (int n = 1; n < argc; ++n) {
+        if ((n + 1 < argc) && (0 == strcmp(argv[n], "-s"))) {
+            Sscanf(argv[++n], 3, "%d*%d*%d", &(m[X]), &(m[Y]), &(m[Z]));
+            continue;
+        }
+        if ((n + 1 < argc) && (0 == strcmp(argv[n], "-r"))) {
+            Sscanf(argv[++n], 1, "%d", &repN);
+            continue;
+        }
+        if ((n + 1 < argc) && (0 == strcmp(argv[n], "-o"))) {
+            fname = argv[++n];
+            continue;
+        }
+        ShowError("usage: %s [-s mx*my*mz] [-r repeats] [-o file]", argv[0]);
+    }
+    repN = MinInt(MaxInt(repN, 1), REPMAX);
+    char *entry[3] = {argv[0], "-m", "serial"};
+    EnterProgram(3, entry, &control, &space);
+    ConfigureCase(m);
+    Preprocess(&time, &space, &model);
+    InitializeComputeDomain(&time, &space, &model);
+    SynthesizeField(&space, &model);
+    const char *name[BENCHN] = {
+        "ComputeFhat", "ComputeFvhat", "WENO3", "WENO5",
+        "SymmetricAverage+EigenvectorL/R", "TreatBoundary", "PointInPolyhedron",
+        "EvolveFluidDynamics"};
+    const char *unit[BENCHN] = {
+        "interface", "interface", "interface", "interface",
+        "interface", "node", "query",
+        "node"};
+    Benchmark bench[BENCHN] = {
+        BenchFhat, BenchFvhat, BenchWENO3, BenchWENO5,
+        BenchEigenvector, BenchBoundary, BenchPointInPolyhedron,
+        BenchEvolve};
+    Result result[BENCHN] = {{0}};
+    ShowInfo("Session");
+    ShowInfo("Benchmarking...\n");
+    ShowInfo("  %-32s %10s %10s %10s %10s %s\n", "kernel", "min", "median", "stddev", "M/s", "(ns per unit)");
+    for (int n = 0; n < BENCHN; ++n) {
+        result[n].name = name[n];
+        result[n].unit = unit[n];
+        RunBenchmark(repN, bench[n], &space, &model, result + n);
+        if (0 >= result[n].count) {
+            ShowInfo("  %-32s skipped\n", result[n].name);
+            continue;
+        }
+        ShowInfo("  %-32s %10.4g %10.4g %10.4g %10.4g %s\n", result[n].name, result[n].min,
+                result[n].median, result[n].stddev, 1.0e3 / result[n].median, result[n].unit);
+    }
+    WriteResult(fname, repN, result, &space, &model);
+    ShowInfo("  results written to %s\n", fname);
+    ShowInfo("Session");
+    Postprocess(&time, &space, &model);
+    exit(EXIT_SUCCESS);
+}
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Generate the default case files, set the mesh number, and enable
+ * viscous fluxes so that diffusive fluxes are actually computed.
+ */
+static void ConfigureCase(const IntVec m)
+{
+    GenerateCaseFiles();
+    FILE *fp = Fopen("artracfd.case", "r");
+    FILE *fpt = Fopen("artracfd.case.tmp", "w");
+    String str = {'\0'}; /* store the current read line */
+    int line = NONE; /* line count after the space section begins */
+    while (NULL != fgets(str, sizeof str, fp)) {
+        if (0 == strncmp(str, "space begin", strlen("space begin"))) {
+            line = 0;
+        }
+        if (3 == line) {
+            snprintf(str, sizeof str, "%d, %d, %d # mx, my, mz\n", m[X], m[Y], m[Z]);
+        }
+        if (NONE != line) {
+            ++line;
+        }
+        if (NULL != strstr(str, "# viscous level")) {
+            snprintf(str, sizeof str, "1 # viscous level\n");
+        }
+        fputs(str, fpt);
+    }
+    fclose(fp);
+    fclose(fpt);
+    if (0 != rename("artracfd.case.tmp", "artracfd.case")) {
+        ShowError("failed to configure the benchmark case");
+    }
+    return;
+}
+/*
+ * Replace the field by a smooth flow with waves in all directions, so that
+ * the nonlinear weights of reconstructions and the eigenvectors vary over
+ * the field as in a real computation.
+ */
+static void SynthesizeField(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    Real Uo[DIMUo] = {0.0};
+    Real U[DIMU] = {0.0};
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != field->did[idx]) {
+                    continue;
+                }
+                const Real x = MapPoint(i, part->domain[X][MIN], part->d[X], part->n0[X]);
+                const Real y = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]);
+                const Real z = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z]);
+                Uo[0] = 1.0 + 0.2 * sin(2.0 * x) * cos(3.0 * y) * cos(z);
+                Uo[1] = 0.3 * sin(y + z);
+                Uo[2] = 0.3 * cos(x + z);
+                Uo[3] = 0.3 * sin(x - y);
+                Uo[4] = 1.0 / model->gamma + 0.1 * cos(3.0 * x) * sin(2.0 * y);
+                MapConservative(model->gamma, Uo, U);
+                ScatterU(idx, U, field->U[TO]);
+            }
+        }
+    }
+    TreatBoundary(TO, space, model);
+    return;
+}
+/*
+ * Each benchmark runs a kernel once over its work and returns the units of
+ * work done.
+ */
+static long BenchFhat(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const int stride[DIMS+1] = {1, part->n[X], part->n[X] * part->n[Y], 0};
+    Real Fhat[DIMU] = {0.0};
+    long count = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    ComputeFhat(TO, s, k, j, i, stride, &(space->field), model, Fhat);
+                    sink = sink + Fhat[0];
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+static long BenchFvhat(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const int stride[DIMS+1] = {1, part->n[X], part->n[X] * part->n[Y], 0};
+    Real Fvhat[DIMU] = {0.0};
+    long count = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    ComputeFvhat(TO, s, k, j, i, stride, part->dd, &(space->field), model, Fvhat);
+                    sink = sink + Fvhat[1];
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+/*
+ * Reconstructions run over a pool of stencils sampled from smooth and
+ * discontinuous profiles.
+ */
+static long BenchWENO3(Space *space, const Model *model)
+{
+    static Real F[POOLN][3][DIMU];
+    static int pool = 0; /* pool generated */
+    Real Fhat[DIMU] = {0.0};
+    if (0 == pool) {
+        pool = 1;
+        for (int m = 0; m < POOLN; ++m) {
+            for (int r = 0; r < 3; ++r) {
+                for (int n = 0; n < DIMU; ++n) {
+                    F[m][r][n] = (0 == m % 8) ? 1.0 + (Real)(r > 1) : 1.0 + 0.1 * Random();
+                }
+            }
+        }
+    }
+    for (int pass = 0; pass < PASSN; ++pass) {
+        for (int m = 0; m < POOLN; ++m) {
+            WENO3(F[m], Fhat);
+            sink = sink + Fhat[0];
+        }
+    }
+    (void)space;
+    (void)model;
+    return (long)PASSN * POOLN;
+}
+static long BenchWENO5(Space *space, const Model *model)
+{
+    static Real F[POOLN][5][DIMU];
+    static int pool = 0; /* pool generated */
+    Real Fhat[DIMU] = {0.0};
+    if (0 == pool) {
+        pool = 1;
+        for (int m = 0; m < POOLN; ++m) {
+            for (int r = 0; r < 5; ++r) {
+                for (int n = 0; n < DIMU; ++n) {
+                    F[m][r][n] = (0 == m % 8) ? 1.0 + (Real)(r > 2) : 1.0 + 0.1 * Random();
+                }
+            }
+        }
+    }
+    for (int pass = 0; pass < PASSN; ++pass) {
+        for (int m = 0; m < POOLN; ++m) {
+            WENO5(F[m], Fhat);
+            sink = sink + Fhat[0];
+        }
+    }
+    (void)space;
+    (void)model;
+    return (long)PASSN * POOLN;
+}
+static long BenchEigenvector(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    Real UL[DIMU] = {0.0};
+    Real UR[DIMU] = {0.0};
+    Real Uo[DIMUo] = {0.0};
+    Real L[DIMU][DIMU] = {{0.0}};
+    Real R[DIMU][DIMU] = {{0.0}};
+    long count = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX] - 1; ++i) {
+                    GatherU(IndexNode(k, j, i, part->n[Y], part->n[X]), field->U[TO], UL);
+                    GatherU(IndexNode(k, j, i + 1, part->n[Y], part->n[X]), field->U[TO], UR);
+                    SymmetricAverage(model->jacobMean, model->gamma, UL, UR, Uo);
+                    EigenvectorL(s, model->gamma, Uo, L);
+                    EigenvectorR(s, Uo, R);
+                    sink = sink + L[0][0] + R[0][0];
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+static long BenchBoundary(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    TreatBoundary(TO, space, model);
+    return (long)part->n[X] * part->n[Y] * part->n[Z];
+}
+/*
+ * Queries are uniformly distributed in a slightly enlarged bounding box of
+ * the first triangulated polyhedron. Nothing is timed if there is none.
+ */
+static long BenchPointInPolyhedron(Space *space, const Model *model)
+{
+    const Geometry *const geo = &(space->geo);
+    if (0 == geo->stlN) {
+        return 0;
+    }
+    const Polyhedron *const poly = geo->poly + geo->sphN;
+    RealVec p = {0.0};
+    int fid = 0;
+    long count = 0;
+    seed = 1;
+    for (int m = 0; m < POOLN; ++m) {
+        for (int s = 0; s < DIMS; ++s) {
+            p[s] = poly->box[s][MIN] + (poly->box[s][MAX] - poly->box[s][MIN]) * (1.1 * Random() - 0.05);
+        }
+        sink = sink + PointInPolyhedron(p, poly, &fid);
+        ++count;
+    }
+    (void)model;
+    return count;
+}
+/*
+ * A full time step with a small time step size, so the field stays close
+ * to the synthetic state over repeats.
+ */
+static long BenchEvolve(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const Real dt = 0.05 * MinReal(part->d[X], MinReal(part->d[Y], part->d[Z]));
+    EvolveFluidDynamics(dt, space, model);
+    return (long)(part->ns[PIN][X][MAX] - part->ns[PIN][X][MIN]) *
+        (part->ns[PIN][Y][MAX] - part->ns[PIN][Y][MIN]) *
+        (part->ns[PIN][Z][MAX] - part->ns[PIN][Z][MIN]);
+}
+/*
+ * Time repN repeats of a benchmark after a warm-up run, and compute the
+ * statistics of the time per unit of work.
+ */
+static void RunBenchmark(const int repN, Benchmark bench, Space *space, const Model *model, Result *result)
+{
+    Real t[REPMAX] = {0.0};
+    Timer tm;
+    result->count = bench(space, model);
+    if (0 >= result->count) {
+        return;
+    }
+    for (int n = 0; n < repN; ++n) {
+        TickTime(&tm);
+        bench(space, model);
+        t[n] = 1.0e9 * TockTime(&tm) / (Real)result->count;
+    }
+    /* insertion sort for the median */
+    for (int n = 1; n < repN; ++n) {
+        const Real key = t[n];
+        int m = n - 1;
+        for (; (0 <= m) && (t[m] > key); --m) {
+            t[m+1] = t[m];
+        }
+        t[m+1] = key;
+    }
+    Real mean = 0.0;
+    for (int n = 0; n < repN; ++n) {
+        mean = mean + t[n] / repN;
+    }
+    Real var = 0.0;
+    for (int n = 0; n < repN; ++n) {
+        var = var + (t[n] - mean) * (t[n] - mean) / repN;
+    }
+    result->min = t[0];
+    result->median = (0 == repN % 2) ? 0.5 * (t[repN/2-1] + t[repN/2]) : t[repN/2];
+    result->stddev = sqrt(var);
+    return;
+}
+static void WriteResult(const char *fname, const int repN, const Result result[], const Space *space,
+        const Model *model)
+{
+    const Partition *const part = &(space->part);
+    FILE *fp = Fopen(fname, "w");
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"mesh\": [%d, %d, %d],\n", part->m[X], part->m[Y], part->m[Z]);
+    fprintf(fp, "  \"repeats\": %d,\n", repN);
+    fprintf(fp, "  \"real_bytes\": %zu,\n", sizeof(Real));
+    fprintf(fp, "  \"field_bytes\": %zu,\n", sizeof(FdReal));
+    fprintf(fp, "  \"isa\": %d,\n", model->isa);
+    fprintf(fp, "  \"temporal_scheme\": %d,\n", model->tScheme);
+    fprintf(fp, "  \"spatial_scheme\": %d,\n", model->sScheme);
+    fprintf(fp, "  \"flux_kernel\": %d,\n", model->fluxKernel);
+    fprintf(fp, "  \"results\": [\n");
+    for (int n = 0; n < BENCHN; ++n) {
+        fprintf(fp, "    {\"kernel\": \"%s\", \"unit\": \"%s\", \"count\": %ld, "
+                "\"ns_min\": %.6g, \"ns_median\": %.6g, \"ns_stddev\": %.6g, \"mega_per_s\": %.6g}%s\n",
+                result[n].name, result[n].unit, result[n].count, result[n].min, result[n].median,
+                result[n].stddev, (0.0 < result[n].median) ? 1.0e3 / result[n].median : 0.0,
+                (BENCHN - 1 == n) ? "" : ",");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+    fclose(fp);
+    return;
+}
+/*
+ * A linear congruential generator giving reproducible inputs in [0, 1).
+ */
+static Real Random(void)
+{
+    seed = (seed * 1103515245UL + 12345UL) % 2147483648UL;
+    return (Real)seed / 2147483648.0;
+}
+/* a good practice: end file with a newline */
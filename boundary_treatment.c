@@ -14,6 +14,8 @@
 #include "boundary_treatment.h"
 #include <stdio.h> /* standard library for input and output */
 #include "immersed_boundary.h"
+#include "message_passing.h"
+#include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -21,12 +23,20 @@
  ****************************************************************************/
 static void ApplyBoundaryCondition(const int, const int, int [restrict][LIMIT],
         const int, Space *, const Model *);
-static void EnforceZeroGradient(const Real [restrict], Real [restrict]);
+static void EnforceZeroGradient(const int, const int, FdReal *const [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void TreatBoundary(const int tn, Space *space, const Model *model)
 {
+    /*
+     * Partition boundary treatment
+     * Halos shared with neighbouring partitions are refreshed before the
+     * immersed boundary treatment, which uses them as stencils, and after
+     * the external boundary treatment, which updates nodes sent to them.
+     */
+    StartRegion(RGBOUNDARY);
+    ExchangeFieldData(tn, space);
     /*
      * Internal boundary treatment
      * Should be performed first to ensure stencils for diffusive flux
@@ -50,6 +60,9 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
     int box[DIMS][LIMIT] = {{0}}; /* range box of numerical boundary */
     for (int r = 0; r <= R; ++r) { /* process layer by layer */
         for (int p = PWB; p <= PBB; ++p) {
+            if (NONE != part->nbr[p]) { /* a partition boundary */
+                continue;
+            }
             const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
             for (int s = 0; s < DIMS; ++s) { /* compute range box of each layer */
                 box[s][MIN] = part->ns[p][s][MIN] + MinInt(r, ng[s]) * (N[s] - !N[s]);
@@ -61,13 +74,15 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
             ApplyBoundaryCondition(p, r, box, tn, space, model);
         }
     }
+    ExchangeFieldData(tn, space);
+    StopRegion(RGBOUNDARY);
     return;
 }
 static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][LIMIT],
         const int tn, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    FdReal *const *const Uf = space->field.U[tn];
     const Real zero = 0.0;
     const Real UoGiven[DIMUo] = { /* specified primitive values of current boundary */
         part->varBC[p][0],
@@ -78,21 +93,23 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
         part->varBC[p][5]};
     const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
     const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
-    Real *restrict UG = NULL;
-    Real *restrict UI = NULL;
-    Real *restrict UO = NULL;
-    Real *restrict Uh = NULL;
-    int idxG = 0; /* index at ghost node */
-    int idxI = 0; /* index at image node */
-    int idxO = 0; /* index at boundary point */
-    int idxh = 0; /* index at neighbouring point */
-    Real UoG[DIMUo] = {zero};
-    Real UoI[DIMUo] = {zero};
-    Real UoO[DIMUo] = {zero};
-    Real Uoh[DIMUo] = {zero};
+    /* nodes in a box layer only depend on nodes in other layers */
+    #pragma omp parallel for collapse(3) schedule(static)
     for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
         for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
             for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                Real UG[DIMU] = {zero};
+                Real UI[DIMU] = {zero};
+                Real UO[DIMU] = {zero};
+                Real Uh[DIMU] = {zero};
+                int idxG = 0; /* index at ghost node */
+                int idxI = 0; /* index at image node */
+                int idxO = 0; /* index at boundary point */
+                int idxh = 0; /* index at neighbouring point */
+                Real UoG[DIMUo] = {zero};
+                Real UoI[DIMUo] = {zero};
+                Real UoO[DIMUo] = {zero};
+                Real Uoh[DIMUo] = {zero};
                 /*
                  * Apply boundary conditions for current node, always remember
                  * that boundary conditions should be based on primitive
@@ -100,49 +117,46 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                  */
                 if (0 != r) { /* treat ghost layers */
                     idxG = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    UG = node[idxG].U[tn];
                     switch (part->typeBC[p]) {
                         case SLIPWALL:
                             /* fall through */
                         case NOSLIPWALL:
                             idxO = IndexNode(k - r*N[Z], j - r*N[Y], i - r*N[X], part->n[Y], part->n[X]);
-                            UO = node[idxO].U[tn];
+                            GatherU(idxO, Uf, UO);
                             MapPrimitive(model->gamma, model->gasR, UO, UoO);
                             idxI = IndexNode(k - 2*r*N[Z], j - 2*r*N[Y], i - 2*r*N[X], part->n[Y], part->n[X]);
-                            UI = node[idxI].U[tn];
+                            GatherU(idxI, Uf, UI);
                             MapPrimitive(model->gamma, model->gasR, UI, UoI);
                             DoMethodOfImage(UoI, UoO, UoG);
                             UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
                             MapConservative(model->gamma, UoG, UG);
+                            ScatterU(idxG, UG, Uf);
                             break;
                         case PERIODIC:
                             idxh = IndexNode(k - LN[Z], j - LN[Y], i - LN[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            EnforceZeroGradient(Uh, UG);
+                            EnforceZeroGradient(idxh, idxG, Uf);
                             break;
                         default:
                             idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            EnforceZeroGradient(Uh, UG);
+                            EnforceZeroGradient(idxh, idxG, Uf);
                             break;
                     }
                     continue;
                 }
                 idxO = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                UO = node[idxO].U[tn];
                 switch (part->typeBC[p]) { /* treat physical boundary */
                     case INFLOW:
                         MapConservative(model->gamma, UoGiven, UO);
+                        ScatterU(idxO, UO, Uf);
                         break;
                     case OUTFLOW:
                         /* Calculate inner neighbour nodes according to normal vector direction. */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
-                        EnforceZeroGradient(Uh, UO);
+                        EnforceZeroGradient(idxh, idxO, Uf);
                         break;
                     case SLIPWALL: /* zero-gradient for scalar and tangential component, zero for normal component */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        GatherU(idxh, Uf, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = (!N[X]) * Uoh[1];
                         UoO[2] = (!N[Y]) * Uoh[2];
@@ -155,10 +169,11 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         }
                         UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
                         MapConservative(model->gamma, UoO, UO);
+                        ScatterU(idxO, UO, Uf);
                         break;
                     case NOSLIPWALL:
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        GatherU(idxh, Uf, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = zero;
                         UoO[2] = zero;
@@ -171,6 +186,7 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         }
                         UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
                         MapConservative(model->gamma, UoO, UO);
+                        ScatterU(idxO, UO, Uf);
                         break;
                     case PERIODIC:
                         /* no treatment needed since the boundary participates normal computation */
@@ -183,10 +199,10 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
     }
     return;
 }
-static void EnforceZeroGradient(const Real Uh[restrict], Real U[restrict])
+static void EnforceZeroGradient(const int idxh, const int idx, FdReal *const Uf[restrict])
 {
     for (int n = 0; n < DIMU; ++n) {
-        U[n] = Uh[n];
+        Uf[n][idx] = Uf[n][idxh];
     }
     return;
 }
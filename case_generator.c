@@ -68,6 +68,9 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "0                  # maximum computing steps (int; 0: auto)\n");
     fprintf(fp, "1                  # space data writing frequency (int; 0: inf)\n");
     fprintf(fp, "1                  # data streamer (int; 0: ParaView; 1: Ensight)\n");
+    fprintf(fp, "0                  # timing trace (int; 0: off; 1: per-step trace)\n");
+    fprintf(fp, "0                  # hardware counters (int; 0: off; 1: per-region counts)\n");
+    fprintf(fp, "0                  # roofline report (int; 0: off; 1: kernel roofline)\n");
     fprintf(fp, "time end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
@@ -75,13 +78,16 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "#\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "numerical begin\n");
-    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3;)\n");
+    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3; 2: low-storage RK2; 3: low-storage RK3, TVD for CFL <= 0.32;)\n");
     fprintf(fp, "1                  # spatial scheme (int; 0: WENO3; 1: WENO5;)\n");
     fprintf(fp, "0                  # dimension scheme (int; 0: dim split; 1: dim by dim)\n");
     fprintf(fp, "0                  # Jacobian average (int; 0: Arithmetic; 1: Roe)\n");
     fprintf(fp, "0                  # flux splitting method (int; 0: LLF; 1: SW)\n");
     fprintf(fp, "0                  # phase interaction (int; 0: F; 1: FSI; 2: FSI+SSI)\n");
     fprintf(fp, "1                  # ibm reconstruction layers (int; 0: inf)\n");
+    fprintf(fp, "0                  # flux kernel (int; 0: nodal; 1: pencil)\n");
+    fprintf(fp, "0                  # distance grid (int; 0: off; 1: body-frame cache)\n");
+    fprintf(fp, "0.0                # remap tolerance (real; mesh sizes of drift; 0: every update, exact; > 0: faster, boundary lags)\n");
     fprintf(fp, "numerical end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
@@ -331,6 +337,7 @@ static void GenerateCaseGeometryFile(void)
     fprintf(fp, "0, 0, 0, 0.5, 0, 0, 0, 0, 0, 0, 2700, -1, 1, 0, 0, 0\n");
     fprintf(fp, "0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0\n");
     fprintf(fp, "polyhedron state end\n");
+    fprintf(fp, "# rotate: Euler angles about x, y, z in turn, applied relative to O\n");
     fprintf(fp, "polyhedron transform begin\n");
     fprintf(fp, "1, 1, 1, 0, 0, 0, 0, 0, 0 # scale, rotate, translate\n");
     fprintf(fp, "polyhedron transform end\n");
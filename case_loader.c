@@ -22,6 +22,7 @@ static void ReadCaseSettingData(Time *, Space *, Model *);
 static void ReadGeometrySettingData(Geometry *const);
 static void ReadBoundaryData(FILE *, Space *, const int);
 static void ReadConsecutiveData(FILE *, const int, const char *, Real *, char [][VARSTR]);
+static int ReadOptionalData(FILE *, const int, const char *, const char *, void *);
 static void WriteBoundaryData(FILE *, const Space *, const int);
 static void WriteInitializerData(FILE *, const Space *, const int);
 static void WriteVerifyData(const Time *, const Space *, const Model *);
@@ -33,25 +34,28 @@ void LoadCaseData(Time *time, Space *space, Model *model)
 {
     ReadCaseSettingData(time, space, model);
     ReadGeometrySettingData(&(space->geo));
-    WriteVerifyData(time, space, model);
+    if (0 == space->part.rank) { /* only the root process writes shared files */
+        WriteVerifyData(time, space, model);
+    }
     CheckCaseSettingData(time, space, model);
     return;
 }
 static void ReadCaseSettingData(Time *time, Space *space, Model *model)
 {
     Partition *const part = &(space->part);
-    part->typeBC = AssignStorage(NBC * sizeof(*part->typeBC));
-    part->N = AssignStorage(NBC * sizeof(*part->N));
-    part->varBC = AssignStorage(NBC * sizeof(*part->varBC));
-    part->typeIC = AssignStorage(NIC * sizeof(*part->typeIC));
-    part->posIC = AssignStorage(NIC * sizeof(*part->posIC));
-    part->varIC = AssignStorage(NIC * sizeof(*part->varIC));
+    part->typeBC = AssignStorage(NBC * sizeof(*part->typeBC), MEMPARTITION);
+    part->N = AssignStorage(NBC * sizeof(*part->N), MEMPARTITION);
+    part->varBC = AssignStorage(NBC * sizeof(*part->varBC), MEMPARTITION);
+    part->typeIC = AssignStorage(NIC * sizeof(*part->typeIC), MEMPARTITION);
+    part->posIC = AssignStorage(NIC * sizeof(*part->posIC), MEMPARTITION);
+    part->varIC = AssignStorage(NIC * sizeof(*part->varIC), MEMPARTITION);
     const char *fname = "artracfd.case";
     FILE *fp = Fopen(fname, "r");
     String str = {'\0'}; /* store the current read line */
     int nentry = 0; /* entry count */
     const char *fmtI = ParseFormat("%lg");
     const char *fmtJ = ParseFormat("%lg, %lg, %lg");
+    int open = 0; /* whether optional entries of the section remain */
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "space begin", sizeof str)) {
@@ -71,6 +75,12 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(time->stepN));
             Sread(fp, 1, "%d", &(time->dataW[PROSD]));
             Sread(fp, 1, "%d", &(time->dataStreamer));
+            time->trace = 0;
+            time->counter = 0;
+            time->roofline = 0;
+            open = ReadOptionalData(fp, 1, "time end", "%d", &(time->trace));
+            open = ReadOptionalData(fp, open, "time end", "%d", &(time->counter));
+            ReadOptionalData(fp, open, "time end", "%d", &(time->roofline));
             continue;
         }
         if (0 == strncmp(str, "numerical begin", sizeof str)) {
@@ -82,6 +92,12 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(model->fluxSplit));
             Sread(fp, 1, "%d", &(model->psi));
             Sread(fp, 1, "%d", &(model->ibmLayer));
+            model->fluxKernel = 0;
+            model->distGrid = 0;
+            model->remapTol = 0.0;
+            open = ReadOptionalData(fp, 1, "numerical end", "%d", &(model->fluxKernel));
+            open = ReadOptionalData(fp, open, "numerical end", "%d", &(model->distGrid));
+            ReadOptionalData(fp, open, "numerical end", fmtI, &(model->remapTol));
             continue;
         }
         if (0 == strncmp(str, "material begin", sizeof str)) {
@@ -189,10 +205,10 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(time->dataN[PROCV]));
             Sread(fp, 1, "%d", &(time->dataN[PROFC]));
             if (0 < time->dataN[PROPT]) {
-                time->pp = AssignStorage(time->dataN[PROPT] * sizeof(*time->pp));
+                time->pp = AssignStorage(time->dataN[PROPT] * sizeof(*time->pp), MEMPROBE);
             }
             if (0 < time->dataN[PROLN]) {
-                time->lp = AssignStorage(time->dataN[PROLN] * sizeof(*time->lp));
+                time->lp = AssignStorage(time->dataN[PROLN] * sizeof(*time->lp), MEMPROBE);
             }
             continue;
         }
@@ -299,6 +315,29 @@ static void ReadConsecutiveData(FILE *fp, const int n, const char *fmt,
     }
     return;
 }
+/*
+ * Entries added to a section after its required ones are optional. An entry
+ * missing before the section end keeps its default, hence case files without
+ * newer entries still load. Once the end is met, the section is closed and
+ * the remaining optional entries of the section are not read.
+ */
+static int ReadOptionalData(FILE *fp, const int open, const char *end,
+        const char *fmt, void *data)
+{
+    String str = {'\0'};
+    if (0 == open) {
+        return 0;
+    }
+    if (NULL == fgets(str, sizeof str, fp)) {
+        return 0;
+    }
+    ParseCommand(str);
+    if (0 == strncmp(str, end, sizeof str)) {
+        return 0;
+    }
+    Sscanf(str, 1, fmt, data);
+    return 1;
+}
 static void WriteBoundaryData(FILE *fp, const Space *space, const int n)
 {
     const Partition *const part = &(space->part);
@@ -406,6 +445,9 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "maximum computing steps: %d\n", time->stepN);
     fprintf(fp, "space data writing frequency: %d\n", time->dataW[PROSD]);
     fprintf(fp, "data streamer: %d\n", time->dataStreamer);
+    fprintf(fp, "timing trace: %d\n", time->trace);
+    fprintf(fp, "hardware counters: %d\n", time->counter);
+    fprintf(fp, "roofline report: %d\n", time->roofline);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
@@ -418,6 +460,9 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "flux splitting method: %d\n", model->fluxSplit);
     fprintf(fp, "phase interaction: %d\n", model->psi);
     fprintf(fp, "ibm reconstruction layers: %d\n", model->ibmLayer);
+    fprintf(fp, "flux kernel: %d\n", model->fluxKernel);
+    fprintf(fp, "distance grid: %d\n", model->distGrid);
+    fprintf(fp, "remap tolerance: %.6g\n", model->remapTol);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                       >> Material Properties <<\n");
@@ -523,12 +568,14 @@ static void CheckCaseSettingData(const Time *time, const Space *space, const Mod
         ShowError("processor number should be positive");
     }
     /* time */
-    if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL)) {
+    if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL) || (0 > time->trace) ||
+            (0 > time->counter) || (0 > time->roofline)) {
         ShowError("values in time section should not be negative");
     }
     /* numerical method */
     if ((0 > model->tScheme) || (0 > model->sScheme) || (0 > model->multidim) ||
-            (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->psi)) {
+            (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->psi) ||
+            (0 > model->fluxKernel) || (0 > model->distGrid) || (zero > model->remapTol)) {
         ShowError("values in numerical section should not be negative");
     }
     /* material */
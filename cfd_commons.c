@@ -324,6 +324,24 @@ int IndexNode(const int k, const int j, const int i, const int jMax, const int i
 {
     return (k * jMax + j) * iMax + i;
 }
+int IndexStride(const int k, const int j, const int i, const int stride[restrict])
+{
+    return k * stride[Z] + j * stride[Y] + i * stride[X] + stride[DIMS];
+}
+void GatherU(const int idx, FdReal *const Uf[restrict], Real U[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        U[n] = Uf[n][idx];
+    }
+    return;
+}
+void ScatterU(const int idx, const Real U[restrict], FdReal *const Uf[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        Uf[n][idx] = U[n];
+    }
+    return;
+}
 int InPartBox(const int k, const int j, const int i, const int pbox[restrict][LIMIT])
 {
     return
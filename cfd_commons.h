@@ -78,6 +78,25 @@ extern void MapConservative(const Real gamma, const Real Uo[restrict], Real U[re
  *      Calculate the node index.
  */
 extern int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax);
+/*
+ * Index math with strides
+ *
+ * Function
+ *      Calculate the node index in a node space stored with arbitrary
+ *      strides, stride = {i stride, j stride, k stride, index of (0, 0, 0)}.
+ *      For the entire node space, stride = {1, n[X], n[X] * n[Y], 0}
+ *      gives the same index as IndexNode.
+ */
+extern int IndexStride(const int k, const int j, const int i, const int stride[restrict]);
+/*
+ * Field data access
+ *
+ * Function
+ *      Gather the conservative vector of a node from the field arrays of a
+ *      time level, or scatter the conservative vector back to them.
+ */
+extern void GatherU(const int idx, FdReal *const Uf[restrict], Real U[restrict]);
+extern void ScatterU(const int idx, const Real U[restrict], FdReal *const Uf[restrict]);
 /*
  * Verify node region
  *
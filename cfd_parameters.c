@@ -29,6 +29,16 @@ void ComputeParameters(Time *time, Space *space, Model *model)
 {
     SetNodeNumber(space, model);
     InitializeParameters(time, space, model);
+    model->isa = DetectInstructionSet(); /* code path of batched kernels */
+    /* time levels of field data required by the temporal scheme */
+    switch (model->tScheme) {
+        case RKTHREE:
+            model->levelN = 3;
+            break;
+        default:
+            model->levelN = 2;
+            break;
+    }
     return;
 }
 /*
@@ -119,6 +129,9 @@ static void SetNodeNumber(Space *space, Model *model)
         part->m[s] = MaxInt(part->m[s], 2);
         /* total number of nodes (including ghost nodes) */
         part->n[s] = part->m[s] + 1 + 2 * part->ng[s];
+        /* the entire domain before any decomposition */
+        part->mt[s] = part->m[s];
+        part->n0[s] = part->ng[s];
     }
     return;
 }
@@ -16,10 +16,35 @@
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
 #include <stdarg.h> /* variable-length argument lists */
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef union {
+    struct {
+        size_t size; /* size of the storage in bytes */
+        int tag; /* tag of the storage */
+    } info;
+    long double align; /* pad to the alignment of the allocator */
+    void *pointer;
+} StorageHeader;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void AccountStorage(const int, const size_t, const size_t);
 /****************************************************************************
  * Global Real Constants Definition
  ****************************************************************************/
 const Real PI = 3.14159265358979323846;
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char *const storageName[MEMN] = {
+    "field", "geometry", "partition", "probe", "io", "message", "scratch"};
+static size_t storageNow[MEMN] = {0}; /* current storage of each tag */
+static size_t storagePeak[MEMN] = {0}; /* peak storage of each tag */
+static size_t storageTotal = 0; /* current storage of all tags */
+static size_t storageTotalPeak = 0; /* peak storage of all tags */
+static size_t storageBudget = 0; /* storage budget, 0 for no limit */
 /****************************************************************************
  * General functions
  ****************************************************************************/
@@ -136,22 +161,129 @@ void ShowInfo(const char *fmt, ...)
     va_end(args);
     return;
 }
-void *AssignStorage(size_t size)
+/*
+ * Each allocation is preceded by a header recording its size and tag. The
+ * header is padded to the alignment of the allocator so that the returned
+ * address keeps the alignment of malloc. Accounting is shared by threads.
+ */
+void *AssignStorage(size_t size, const int tag)
+{
+    int exceed = 0;
+    #pragma omp critical(storage)
+    {
+        if ((0 < storageBudget) && (storageTotal + size > storageBudget)) {
+            exceed = 1;
+        } else {
+            AccountStorage(tag, size, 0);
+        }
+    }
+    if (0 != exceed) {
+        ShowError("%s storage of %zu bytes exceeds the budget of %zu bytes",
+                storageName[tag], size, storageBudget);
+    }
+    StorageHeader *header = malloc(sizeof(*header) + size);
+    if (NULL == header) {
+        ShowError("memory allocation failed");
+    }
+    memset(header + 1, 0, size);
+    header->info.size = size;
+    header->info.tag = tag;
+    return header + 1;
+}
+void *ReassignStorage(void *pointer, size_t size)
 {
-    void *pointer = malloc(size);
     if (NULL == pointer) {
+        return pointer;
+    }
+    StorageHeader *header = (StorageHeader *)pointer - 1;
+    const size_t sizeOld = header->info.size;
+    const int tag = header->info.tag;
+    int exceed = 0;
+    #pragma omp critical(storage)
+    {
+        if ((0 < storageBudget) && (size > sizeOld) && (storageTotal + size - sizeOld > storageBudget)) {
+            exceed = 1;
+        } else {
+            AccountStorage(tag, size, sizeOld);
+        }
+    }
+    if (0 != exceed) {
+        ShowError("%s storage of %zu bytes exceeds the budget of %zu bytes",
+                storageName[tag], size, storageBudget);
+    }
+    header = realloc(header, sizeof(*header) + size);
+    if (NULL == header) {
         ShowError("memory allocation failed");
     }
-    memset(pointer, 0, size);
-    return pointer;
+    if (size > sizeOld) {
+        memset((char *)(header + 1) + sizeOld, 0, size - sizeOld);
+    }
+    header->info.size = size;
+    return header + 1;
 }
 void RetrieveStorage(void *pointer)
 {
     if (NULL != pointer) {
-        free(pointer);
+        StorageHeader *header = (StorageHeader *)pointer - 1;
+        #pragma omp critical(storage)
+        AccountStorage(header->info.tag, 0, header->info.size);
+        free(header);
     }
     return;
 }
+static void AccountStorage(const int tag, const size_t sizeNew, const size_t sizeOld)
+{
+    storageNow[tag] = storageNow[tag] + sizeNew - sizeOld;
+    storageTotal = storageTotal + sizeNew - sizeOld;
+    if (storagePeak[tag] < storageNow[tag]) {
+        storagePeak[tag] = storageNow[tag];
+    }
+    if (storageTotalPeak < storageTotal) {
+        storageTotalPeak = storageTotal;
+    }
+    return;
+}
+void LimitStorage(const size_t budget)
+{
+    storageBudget = budget;
+    return;
+}
+void CountStorage(Real count[])
+{
+    const Real mega = 1.0 / 1048576.0;
+    for (int n = 0; n < MEMN; ++n) {
+        count[2*n] = storageNow[n] * mega;
+        count[2*n+1] = storagePeak[n] * mega;
+    }
+    count[2*MEMN] = storageTotal * mega;
+    count[2*MEMN+1] = storageTotalPeak * mega;
+    return;
+}
+void ShowStorage(const Real count[])
+{
+    ShowInfo("  storage in megabytes: tag, current, peak\n");
+    for (int n = 0; n < MEMN; ++n) {
+        ShowInfo("    %-10s %12.3f %12.3f\n", storageName[n], count[2*n], count[2*n+1]);
+    }
+    ShowInfo("    %-10s %12.3f %12.3f\n", "total", count[2*MEMN], count[2*MEMN+1]);
+    if (0 < storageBudget) {
+        ShowInfo("    %-10s %12.3f\n", "budget", storageBudget / 1048576.0);
+    }
+    return;
+}
+int DetectInstructionSet(void)
+{
+#ifdef ARTRACFD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return ISAAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return ISAAVX2;
+    }
+#endif
+    return ISASCALAR;
+}
 void ReadInLine(FILE *fp, const char *line)
 {
     String str = {'\0'}; /* store the current read line */
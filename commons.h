@@ -42,7 +42,7 @@ typedef enum {
     COLLAPSEYZ = 8,
     COLLAPSEXYZ = 17,
     /* dimensions related to temporal operator */
-    DIMT = 3, /* number of time levels to store field data */
+    DIMT = 3, /* maximum number of time levels to store field data */
     TO = 0, /* the time level for current */
     TN = 1, /* the time level for intermediate */
     TM = 2, /* the time level for intermediate */
@@ -53,13 +53,20 @@ typedef enum {
     PATHN = 30, /* neighbour searching path */
     PATHSEP = 4, /* layer separator in neighbour searching path: pathN, l1N, l2N, l3N */
     NONE = -1, /* invalid flag */
+    RKTWO = 0, /* 2nd order ssp runge-kutta */
+    RKTHREE = 1, /* 3rd order ssp runge-kutta */
+    LSRKTWO = 2, /* 2nd order low-storage ssp runge-kutta */
+    LSRKTHREE = 3, /* 3rd order low-storage ssp runge-kutta */
     WENOTHREE = 0, /* 3rd order weno */
     WENOFIVE = 1, /* 5th order weno */
     OPTSPLIT = 0, /* operator splitting approximation */
     OPTBYOPT = 1, /* operator-by-operator approximation */
+    ISASCALAR = 0, /* portable code path of batched kernels */
+    ISAAVX2 = 1, /* avx2 code path of batched kernels */
+    ISAAVX512 = 2, /* avx-512 code path of batched kernels */
+    PENCILTILE = 4, /* pencils of a tile along each transverse dimension */
     /* parameters related to domain partitions */
-    NPART = 15, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region */
-    PIO = 0, /* the partition region for data iostream */
+    NPART = 17, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region, iostream region, extended region */
     PIN = 0,
     PWB = 1,
     PEB = 2,
@@ -75,6 +82,8 @@ typedef enum {
     PBG = 12,
     PHY = 13,
     PAL = 14,
+    PIO = 15, /* the partition region for data iostream */
+    PEX = 16, /* inner region extended over halos shared with neighbouring partitions */
     LIMIT = 2, /* number of limits */
     MIN = 0,
     MAX = 1,
@@ -99,6 +108,8 @@ typedef enum {
     DIMTK = 2, /* number of time levels to store kinematic data */
     POLYN = 3, /* polygon facet type */
     EVF = 4, /* edge-vertex-face type */
+    BVLEAF = 4, /* maximum number of faces in a leaf of bounding volume hierarchy */
+    BVDEPTH = 64, /* maximum depth of bounding volume hierarchy traversal */
     /* parameters related to data probes */
     NPROBE = 5, /* point, line, curve, force, space probe */
     PROPT = 0,
@@ -110,11 +121,44 @@ typedef enum {
     /* general parameters */
     STR = 200, /* string length */
     VARSTR =100, /* variable expression length */
+    ALIGNB = 64, /* alignment of field data arrays in bytes */
 } ComConst;
+/*
+ * Tags of dynamically allocated storage
+ */
+typedef enum {
+    MEMFIELD = 0, /* field data */
+    MEMGEOMETRY = 1, /* geometries and materials of solids */
+    MEMPARTITION = 2, /* boundary and initial conditions of partitions */
+    MEMPROBE = 3, /* data probes */
+    MEMIO = 4, /* input and output buffers */
+    MEMMESSAGE = 5, /* message passing buffers */
+    MEMSCRATCH = 6, /* work space of kernels */
+    MEMN = 7, /* number of tags */
+} StorageTag;
+/*
+ * Code paths of vector instruction sets
+ * A kernel body is always inlined into functions compiled for different
+ * instruction sets, and the code path is dispatched at run time according
+ * to the processor. Floating-point contraction must stay disabled (the
+ * default of -std=c99) to keep all code paths bitwise identical.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARTRACFD_X86 /* x86 vector extensions are available */
+#define TARGET(isa) __attribute__((target(isa)))
+#define KERNEL static inline __attribute__((always_inline))
+#else
+#define KERNEL static inline
+#endif
 /*
  * Universe data type to improve portability and maintenance
  */
 typedef double Real; /* real data */
+#ifdef ARTRACFD_MIXED
+typedef float FdReal; /* real data of stored field, arithmetic is done in Real */
+#else
+typedef Real FdReal; /* real data of stored field */
+#endif
 typedef char String[STR]; /* string data */
 typedef int IntVec[DIMS]; /* integer type vector */
 typedef Real RealVec[DIMS]; /* real type vector */
@@ -126,17 +170,64 @@ extern const Real PI;
  * Member structures
  */
 typedef struct {
-    int did; /* domain identifier */
-    int fid; /* closest face identifier */
-    int lid; /* interfacial layer identifier */
-    int gst; /* ghost layer identifier */
-    Real U[DIMT][DIMU]; /* field data at each time level */
-} Node; /* field data */
+    int *head; /* first span of each pencil, with the end of spans appended */
+    int (*span)[LIMIT]; /* node range of each span along its pencil */
+    int spanN; /* number of spans */
+    int spanMax; /* capacity of the span storage */
+    int nodeN; /* number of nodes in all spans */
+} Run; /* spans of contiguous fluid nodes of the pencils along a direction */
+
+typedef struct {
+    int idx; /* linear index of the ghost node */
+    int gid; /* geometry identifier */
+    IntVec n; /* ghost node */
+    IntVec c; /* center node of the stencil search */
+    int h; /* radius of the stencil search */
+    int sm; /* start of the stencil range */
+    int sn; /* end of the stencil range */
+    RealVec p; /* interpolated point, the image point or the ghost point */
+    RealVec pO; /* boundary point */
+    RealVec N; /* normal at the boundary point */
+    Real wO; /* weight of the boundary point */
+} Ghost; /* ghost node with the geometric data of its reconstruction */
+
+typedef struct {
+    int *ghead; /* first ghost node of each layer and polyhedron, with the end appended */
+    Ghost *ghost; /* ghost nodes ordered by layers and polyhedrons */
+    int ghostN; /* number of ghost nodes */
+    int ghostMax; /* capacity of the ghost storage */
+    int *ihead; /* first interfacial node of each layer and polyhedron, with the end appended */
+    int (*inter)[DIMS]; /* interfacial nodes ordered by layers and polyhedrons */
+    int interN; /* number of interfacial nodes */
+    int interMax; /* capacity of the interfacial storage */
+    int *sid; /* linear index of stencil nodes */
+    Real *sw; /* inverse distance weight of stencil nodes */
+    int stencilN; /* number of stencil nodes */
+    int stencilMax; /* capacity of the stencil storage */
+    int (*band)[DIMS][LIMIT]; /* node boxes updated by the last geometric update */
+    int bandN; /* number of node boxes */
+    int bandMax; /* capacity of the node box storage */
+} Interface; /* interfacial nodes and reconstruction stencils of a geometric field */
+
+typedef struct {
+    int *did; /* domain identifier */
+    int *fid; /* closest face identifier */
+    int *lid; /* interfacial layer identifier */
+    int *gst; /* ghost layer identifier */
+    FdReal *U[DIMT][DIMU]; /* field data of each variable at each time level */
+    int *tag; /* storage block of identifiers */
+    FdReal *var; /* storage block of field data */
+    int stride; /* padded length of each array */
+    Run run[DIMS]; /* fluid spans of the pencils along each direction */
+    Interface ibm; /* interfacial nodes of polyhedrons */
+} Field; /* field data stored as structure of arrays */
 
 typedef struct {
     IntVec m; /* mesh number of spatial dimensions */
     IntVec n; /* node number of spatial dimensions */
     IntVec ng; /* number of ghost node layers of spatial dimensions */
+    IntVec n0; /* node index mapped to the lower limit of the entire domain */
+    IntVec mt; /* mesh number of the entire domain */
     int gl; /* number of ghost node layers required by numerical scheme */
     int collapse; /* space collapse flag */
     RealVec d; /* mesh size of spatial dimensions */
@@ -156,6 +247,10 @@ typedef struct {
     Real domain[DIMS][LIMIT]; /* coordinates define the space domain */
     IntVec proc; /* number of processors of spatial dimensions */
     int procN; /* total number of processors */
+    int rank; /* rank of current process */
+    int rankN; /* number of processes sharing the domain by message passing */
+    IntVec pid; /* coordinates of current process in the processor grid */
+    int nbr[NBC]; /* neighbouring process of each boundary, NONE for domain boundary */
 } Partition; /* domain discretization and partition */
 
 typedef struct {
@@ -165,6 +260,13 @@ typedef struct {
     RealVec v2; /* vertex */
 } Facet; /* polyhedron facet */
 
+typedef struct {
+    Real box[DIMS][LIMIT]; /* bounding box in the body frame */
+    int next; /* right child of an inner node, NONE for a leaf */
+    int fm; /* start of the face range of a leaf */
+    int fn; /* end of the face range of a leaf */
+} BvNode; /* node of bounding volume hierarchy, the left child follows its parent */
+
 typedef struct {
     int gid; /* geometry identifier */
     IntVec N; /* line of impact */
@@ -175,10 +277,14 @@ typedef struct {
     int edgeN; /* number of edges */
     int vertN; /* number of vertices */
     int state; /* dynamic motion indicator */
+    int remap; /* nodes are remapped by current geometric update */
+    int mesh; /* polyhedron owning the body-frame mesh shared by instances */
     int mid; /* material type */
     Real r; /* bounding sphere radius */
     RealVec O; /* centroid */
     Real I[DIMS][DIMS]; /* inertia matrix */
+    RealVec Om; /* centroid in the body frame */
+    Real Im[DIMS][DIMS]; /* inertia matrix in the body frame */
     Real V[DIMTK][DIMS]; /* translational velocity */
     Real W[DIMTK][DIMS]; /* rotational velocity */
     Real at[DIMTK][DIMS]; /* translational acceleration */
@@ -194,13 +300,27 @@ typedef struct {
     Real area; /* area */
     Real volume; /* volume */
     Real box[DIMS][LIMIT]; /* a bounding box of the polyhedron */
+    Real mbox[DIMS][LIMIT]; /* bounding box at the last node mapping */
+    Real drift; /* bound of surface displacement since the last node mapping */
     int (*restrict f)[POLYN]; /* face-vertex list */
-    Real (*restrict Nf)[DIMS]; /* face normal */
+    Real (*restrict Nf)[DIMS]; /* face normal in the body frame */
     int (*restrict e)[EVF]; /* edge-vertex-face list */
-    Real (*restrict Ne)[DIMS]; /* edge normal */
-    Real (*restrict v)[DIMS]; /* vertex list */
-    Real (*restrict Nv)[DIMS]; /* vertex normal */
+    Real (*restrict Ne)[DIMS]; /* edge normal in the body frame */
+    Real (*restrict v)[DIMS]; /* vertex list in the body frame */
+    Real (*restrict Nv)[DIMS]; /* vertex normal in the body frame */
     Facet *facet; /* facet data */
+    int nodeN; /* number of nodes of bounding volume hierarchy */
+    Real Qb[4]; /* unit quaternion of the body frame orientation, scalar first */
+    Real Rb[DIMS][DIMS]; /* rotation from the body frame to the current frame, by Qb */
+    RealVec Ob; /* origin of the body frame in the current frame */
+    BvNode *bv; /* bounding volume hierarchy of faces in the body frame */
+    int *restrict bf; /* face list ordered by leaves of bounding volume hierarchy */
+    IntVec gn; /* node number of distance grid */
+    Real gh; /* spacing of distance grid */
+    RealVec gO; /* first node of distance grid in the body frame */
+    Real band; /* distance to surface within which queries are exact */
+    Real *restrict gd; /* signed distance grid in the body frame, negative inside */
+    int *restrict gf; /* closest face of distance grid nodes */
 } Polyhedron; /* polyhedron */
 
 typedef struct {
@@ -221,7 +341,7 @@ typedef struct {
  * Memory of pointer type members should be dynamically allocated from heap.
  */
 typedef struct {
-    Node *node; /* field data */
+    Field field; /* field data */
     Geometry geo; /* geometry data */
     Partition part; /* domain discretization and partition data */
 } Space;
@@ -233,6 +353,9 @@ typedef struct {
     int dataN[NPROBE]; /* number for each data probe type */
     int dataW[NPROBE]; /* writing frequency for each data probe type */
     int dataStreamer; /* data streamer */
+    int trace; /* per-step timing trace */
+    int counter; /* hardware performance counters */
+    int roofline; /* roofline report of kernels */
     int dataC; /* data writing count */
     Real end; /* termination time */
     Real now; /* current time recorder */
@@ -243,6 +366,7 @@ typedef struct {
 
 typedef struct {
     int tScheme; /* temporal discretization scheme */
+    int levelN; /* number of time levels of field data required by the temporal scheme */
     int sScheme; /* spatial discretization scheme */
     int sL; /* left offset of stencil index */
     int sR; /* right offset of stencil index */
@@ -251,6 +375,10 @@ typedef struct {
     int fluxSplit; /* flux vector splitting method */
     int psi; /* phase interaction type */
     int ibmLayer; /* number of interfacial layers using flow reconstruction */
+    int fluxKernel; /* kernel computing numerical fluxes of spatial operators */
+    int distGrid; /* body-frame distance grid of triangulated polyhedrons */
+    Real remapTol; /* drift in mesh sizes below which polyhedrons are not remapped; 0: exact */
+    int isa; /* vector instruction set dispatched for batched kernels */
     int mid; /* material identifier */
     int gState; /* gravity state */
     int sState; /* source state */
@@ -270,6 +398,8 @@ typedef struct {
 typedef struct {
     char runMode; /* running mode */
     IntVec proc; /* number of processors per dimension */
+    Real budget; /* storage budget per process in megabytes, 0 for no limit */
+    const char *reference; /* reference solution file to write or compare with */
 } Control;
 /****************************************************************************
  * Public Functions Declaration
@@ -328,9 +458,19 @@ extern void ShowInfo(const char *fmt, ...);
  *
  * Function
  *      Return the head address of a linear array of dynamically allocated
- *      memory that is initialized to zero.
+ *      memory that is initialized to zero. The size is accounted to the tag,
+ *      and the program aborts if the allocation would exceed the budget.
  */
-extern void *AssignStorage(size_t size);
+extern void *AssignStorage(size_t size, const int tag);
+/*
+ * Reassign storage
+ *
+ * Function
+ *      Resize dynamically allocated memory pointed by the pointer, keeping
+ *      its contents up to the lesser size and its tag. Extended memory is
+ *      initialized to zero.
+ */
+extern void *ReassignStorage(void *pointer, size_t size);
 /*
  * Retrieve storage
  *
@@ -338,6 +478,25 @@ extern void *AssignStorage(size_t size);
  *      Free dynamically allocated memory pointed by the pointer.
  */
 extern void RetrieveStorage(void *pointer);
+/*
+ * Storage accounting
+ *
+ * Function
+ *      Set the storage budget in bytes, 0 for no limit. Count the current
+ *      and peak storage in megabytes of each tag and of all tags into
+ *      2 * (MEMN + 1) entries, and show counted storage.
+ */
+extern void LimitStorage(const size_t budget);
+extern void CountStorage(Real count[]);
+extern void ShowStorage(const Real count[]);
+/*
+ * Detect instruction set
+ *
+ * Function
+ *      Return the widest vector instruction set supported by the processor
+ *      among the code paths of batched kernels.
+ */
+extern int DetectInstructionSet(void);
 /*
  * Auxiliary Functions for File Reading
  *
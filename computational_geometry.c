@@ -22,15 +22,32 @@
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static int AddVertex(const Real [restrict], Polyhedron *);
+static int AddVertex(const Real [restrict], const int, int [restrict], Polyhedron *);
+static unsigned long long HashVertex(const Real [restrict]);
+static int CompareSlot(const void *, const void *);
 static int FindEdge(const int, const int, const int, int [restrict][EVF]);
 static void ComputeParametersSphere(const int, Polyhedron *);
 static void ComputeParametersPolyhedron(const int, Polyhedron *);
-static void TransformVertex(const Real [restrict], const Real [restrict],
-        const Real [restrict][DIMS], const Real [restrict], Real [restrict][LIMIT],
-        const int, Real [restrict][DIMS]);
-static void TransformNormal(const Real [restrict][DIMS], const int, Real [restrict][DIMS]);
-static Real TransformInertia(const Real [restrict], Real [restrict][DIMS]);
+static void EulerQuaternion(const Real [restrict], Real [restrict]);
+static void VectorQuaternion(const Real [restrict], Real [restrict]);
+static void MultiplyQuaternion(const Real [restrict], const Real [restrict], Real [restrict]);
+static void QuaternionMatrix(const Real [restrict], Real [restrict][DIMS]);
+static void PlaceMassProperty(Polyhedron *);
+static void RotateInertia(Polyhedron *);
+static void BoundPolyhedron(Polyhedron *);
+static void BoundBodyBox(Polyhedron *);
+static void BuildBoundingHierarchy(Polyhedron *);
+static int BuildBoundingNode(const int, const int, Real [restrict][DIMS], Polyhedron *);
+static void SelectFace(const int, const int, const int, const int, Real [restrict][DIMS],
+        int [restrict]);
+static Real BoxDistance(const Real [restrict], Real [restrict][LIMIT]);
+static int LineHitBox(const Real [restrict], const Real [restrict], Real [restrict][LIMIT]);
+static int LineCrossTriangle(const Real [restrict], const int, const Real, const Real,
+        const Polyhedron *, Real [restrict]);
+static int LookupDistanceGrid(const Real [restrict], const Polyhedron *, int [restrict]);
+static int PointInBody(const Real [restrict], const Polyhedron *, int [restrict]);
+static Real IntersectFace(const Real [restrict], const int, const Polyhedron *,
+        Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -38,102 +55,153 @@ void ConvertPolyhedron(Polyhedron *poly)
 {
     /* allocate memory, assume over-estimated vertex and edge */
     AllocatePolyhedronMemory(POLYN * poly->faceN, POLYN * poly->faceN, poly->faceN, poly);
+    /* a hash table of vertices with a load factor no more than one half */
+    int hashN = 1;
+    while (2 * POLYN * poly->faceN > hashN) {
+        hashN = 2 * hashN;
+    }
+    int *hash = AssignStorage(hashN * sizeof(*hash), MEMSCRATCH);
+    for (int n = 0; n < hashN; ++n) {
+        hash[n] = NONE;
+    }
     /* convert representation */
     for (int n = 0; n < poly->faceN; ++n) {
-        poly->f[n][0] = AddVertex(poly->facet[n].v0, poly);
-        poly->f[n][1] = AddVertex(poly->facet[n].v1, poly);
-        poly->f[n][2] = AddVertex(poly->facet[n].v2, poly);
-        AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-        AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-        AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
-    }
-    QuickSortEdge(poly->edgeN, poly->e);
+        poly->f[n][0] = AddVertex(poly->facet[n].v0, hashN, hash, poly);
+        poly->f[n][1] = AddVertex(poly->facet[n].v1, hashN, hash, poly);
+        poly->f[n][2] = AddVertex(poly->facet[n].v2, hashN, hash, poly);
+    }
+    RetrieveStorage(hash);
+    BuildEdge(poly);
     /* adjust the memory allocation */
     RetrieveStorage(poly->facet);
     poly->facet = NULL;
-    poly->e = realloc(poly->e, poly->edgeN * sizeof(*poly->e));
-    poly->Ne = realloc(poly->Ne, poly->edgeN * sizeof(*poly->Ne));
-    poly->v = realloc(poly->v, poly->vertN * sizeof(*poly->v));
-    poly->Nv = realloc(poly->Nv, poly->vertN * sizeof(*poly->Nv));
+    poly->e = ReassignStorage(poly->e, poly->edgeN * sizeof(*poly->e));
+    poly->Ne = ReassignStorage(poly->Ne, poly->edgeN * sizeof(*poly->Ne));
+    poly->v = ReassignStorage(poly->v, poly->vertN * sizeof(*poly->v));
+    poly->Nv = ReassignStorage(poly->Nv, poly->vertN * sizeof(*poly->Nv));
     return;
 }
 void AllocatePolyhedronMemory(const int vertN, const int edgeN,
         const int faceN, Polyhedron *poly)
 {
-    poly->f = AssignStorage(faceN * sizeof(*poly->f));
-    poly->Nf = AssignStorage(faceN * sizeof(*poly->Nf));
-    poly->e = AssignStorage(edgeN * sizeof(*poly->e));
-    poly->Ne = AssignStorage(edgeN * sizeof(*poly->Ne));
-    poly->v = AssignStorage(vertN * sizeof(*poly->v));
-    poly->Nv = AssignStorage(vertN * sizeof(*poly->Nv));
+    poly->f = AssignStorage(faceN * sizeof(*poly->f), MEMGEOMETRY);
+    poly->Nf = AssignStorage(faceN * sizeof(*poly->Nf), MEMGEOMETRY);
+    poly->e = AssignStorage(edgeN * sizeof(*poly->e), MEMGEOMETRY);
+    poly->Ne = AssignStorage(edgeN * sizeof(*poly->Ne), MEMGEOMETRY);
+    poly->v = AssignStorage(vertN * sizeof(*poly->v), MEMGEOMETRY);
+    poly->Nv = AssignStorage(vertN * sizeof(*poly->Nv), MEMGEOMETRY);
+    /* a new mesh is placed with its body frame at the current frame */
+    poly->Qb[0] = 1.0;
+    poly->Qb[1] = 0.0;
+    poly->Qb[2] = 0.0;
+    poly->Qb[3] = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        for (int t = 0; t < DIMS; ++t) {
+            poly->Rb[s][t] = (s == t) ? 1.0 : 0.0;
+        }
+        poly->Ob[s] = 0.0;
+    }
     return;
 }
-static int AddVertex(const Real v[restrict], Polyhedron *poly)
+/*
+ * Vertices are matched by exact coordinates as a linear search over the
+ * vertex list does, and keep the order of their first occurrence. Adding
+ * zero maps a negative zero to zero, which compare equal.
+ */
+static int AddVertex(const Real v[restrict], const int hashN, int hash[restrict], Polyhedron *poly)
 {
-    /* search the vertex list, if already exist, return the index */
-    for (int n = 0; n < poly->vertN; ++n) {
+    /* probe the hash table, if already exist, return the index */
+    int h = (int)(HashVertex(v) & (unsigned long long)(hashN - 1));
+    while (NONE != hash[h]) {
+        const int n = hash[h];
         if ((v[X] == poly->v[n][X]) && (v[Y] == poly->v[n][Y]) &&
                 (v[Z] == poly->v[n][Z])) {
             return n;
         }
+        h = (h + 1) & (hashN - 1);
     }
     /* otherwise, add to the vertex list */
+    hash[h] = poly->vertN;
     poly->v[poly->vertN][X] = v[X];
     poly->v[poly->vertN][Y] = v[Y];
     poly->v[poly->vertN][Z] = v[Z];
     ++(poly->vertN); /* increase pointer */
     return (poly->vertN - 1); /* return index */
 }
-void AddEdge(const int v0, const int v1, const int f, Polyhedron *poly)
+static unsigned long long HashVertex(const Real v[restrict])
 {
-    /* insert by a predefined order */
-    const int vMax = (v0 > v1) ? v0 : v1;
-    const int vMin = (v0 > v1) ? v1 : v0;
-    /* search the edge list, if already exist, add the second face index */
-    for (int n = 0; n < poly->edgeN; ++n) {
-        if ((vMax == poly->e[n][0]) && (vMin == poly->e[n][1])) {
-            poly->e[n][3] = f;
-            return;
-        }
+    unsigned long long h = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        const Real c = v[s] + 0.0;
+        unsigned long long bits = 0;
+        memcpy(&bits, &c, sizeof(c));
+        h = (h ^ bits) * 0x9E3779B97F4A7C15ULL;
+        h = h ^ (h >> 29);
     }
-    /* otherwise, add to the edge list */
-    poly->e[poly->edgeN][0] = vMax;
-    poly->e[poly->edgeN][1] = vMin;
-    poly->e[poly->edgeN][2] = f;
-    ++(poly->edgeN); /* increase pointer */
-    return;
+    return h;
 }
-void QuickSortEdge(const int n, int e[restrict][EVF])
+/*
+ * Edges of faces are bucketed by their greater vertex, and sorted by their
+ * smaller vertex and face in each bucket in parallel, which gives the edge
+ * list ordered by vertex pairs for binary search. Repeated edges become
+ * adjacent and link the first face and the last other face.
+ */
+void BuildEdge(Polyhedron *poly)
 {
-    if (2 > n) {
-        return;
-    }
-    int v[2] = {0};
-    int temp = 0;
-    int i = 0;
-    int j = 0;
-    v[0] = e[n/2][0];
-    v[1] = e[n/2][1];
-    for (i = 0, j = n - 1;; ++i, --j) {
-        while ((e[i][0] < v[0]) || ((e[i][0] == v[0]) && (e[i][1] < v[1]))) {
-            ++i;
-        }
-        while ((e[j][0] > v[0]) || ((e[j][0] == v[0]) && (e[j][1] > v[1]))) {
-            --j;
+    const int slotN = POLYN * poly->faceN;
+    int *head = AssignStorage((poly->vertN + 1) * sizeof(*head), MEMSCRATCH); /* bucket start */
+    int *fill = AssignStorage((poly->vertN + 1) * sizeof(*fill), MEMSCRATCH); /* bucket fill */
+    int (*slot)[2] = AssignStorage(slotN * sizeof(*slot), MEMSCRATCH); /* smaller vertex and face */
+    for (int n = 0; n < poly->faceN; ++n) {
+        for (int m = 0; m < POLYN; ++m) {
+            ++head[MaxInt(poly->f[n][m], poly->f[n][(m+1)%POLYN]) + 1];
         }
-        if (i >= j) {
-            break;
+    }
+    for (int v = 0; v < poly->vertN; ++v) {
+        head[v+1] = head[v+1] + head[v];
+        fill[v] = head[v];
+    }
+    for (int n = 0; n < poly->faceN; ++n) {
+        for (int m = 0; m < POLYN; ++m) {
+            const int v0 = poly->f[n][m];
+            const int v1 = poly->f[n][(m+1)%POLYN];
+            const int l = fill[MaxInt(v0, v1)];
+            slot[l][0] = MinInt(v0, v1);
+            slot[l][1] = n;
+            ++fill[MaxInt(v0, v1)];
         }
-        for (int k = 0; k < EVF; ++k) {
-            temp = e[i][k];
-            e[i][k] = e[j][k];
-            e[j][k] = temp;
+    }
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < poly->vertN; ++v) {
+        qsort(slot + head[v], head[v+1] - head[v], sizeof(*slot), CompareSlot);
+    }
+    poly->edgeN = 0;
+    for (int v = 0; v < poly->vertN; ++v) {
+        for (int l = head[v]; l < head[v+1]; ++l) {
+            if ((head[v] < l) && (slot[l-1][0] == slot[l][0])) { /* edge already exist */
+                poly->e[poly->edgeN-1][3] = slot[l][1];
+                continue;
+            }
+            poly->e[poly->edgeN][0] = v;
+            poly->e[poly->edgeN][1] = slot[l][0];
+            poly->e[poly->edgeN][2] = slot[l][1];
+            ++(poly->edgeN); /* increase pointer */
         }
     }
-    QuickSortEdge(i, e);
-    QuickSortEdge(n - i, e + i);
+    RetrieveStorage(slot);
+    RetrieveStorage(fill);
+    RetrieveStorage(head);
     return;
 }
+static int CompareSlot(const void *a, const void *b)
+{
+    const int *const sa = a;
+    const int *const sb = b;
+    if (sa[0] != sb[0]) {
+        return (sa[0] < sb[0]) ? -1 : 1;
+    }
+    return (sa[1] < sb[1]) ? -1 : ((sa[1] > sb[1]) ? 1 : 0);
+}
 static int FindEdge(const int v0, const int v1, const int n, int e[restrict][EVF])
 {
     /* obtain a predefined order */
@@ -159,105 +227,172 @@ static int FindEdge(const int v0, const int v1, const int n, int e[restrict][EVF
     ShowError("finding edge failed...");
     return -1;
 }
-void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
+/*
+ * Instances share the mesh arrays, the bounding volume hierarchy, the
+ * distance grid, and the properties in the body frame of the owner, and
+ * only the owner releases them.
+ */
+void SharePolyhedron(const Polyhedron *src, Polyhedron *poly)
+{
+    poly->mesh = src->mesh;
+    poly->faceN = src->faceN;
+    poly->edgeN = src->edgeN;
+    poly->vertN = src->vertN;
+    poly->f = src->f;
+    poly->Nf = src->Nf;
+    poly->e = src->e;
+    poly->Ne = src->Ne;
+    poly->v = src->v;
+    poly->Nv = src->Nv;
+    poly->nodeN = src->nodeN;
+    poly->bv = src->bv;
+    poly->bf = src->bf;
+    poly->gh = src->gh;
+    poly->band = src->band;
+    poly->gd = src->gd;
+    poly->gf = src->gf;
+    poly->r = src->r;
+    poly->area = src->area;
+    poly->volume = src->volume;
+    for (int s = 0; s < DIMS; ++s) {
+        poly->gn[s] = src->gn[s];
+        poly->gO[s] = src->gO[s];
+        poly->Om[s] = src->Om[s];
+        for (int t = 0; t < DIMS; ++t) {
+            poly->Im[s][t] = src->Im[s][t];
+        }
+    }
+    return;
+}
+void ScalePolyhedron(const Real scale[restrict], Polyhedron *poly)
+{
+    for (int n = 0; n < poly->vertN; ++n) {
+        poly->v[n][X] = poly->v[n][X] * scale[X];
+        poly->v[n][Y] = poly->v[n][Y] * scale[Y];
+        poly->v[n][Z] = poly->v[n][Z] * scale[Z];
+    }
+    return;
+}
+void BodyToCurrent(const Real q[restrict], const Polyhedron *poly, Real p[restrict])
+{
+    p[X] = Dot(poly->Rb[X], q) + poly->Ob[X];
+    p[Y] = Dot(poly->Rb[Y], q) + poly->Ob[Y];
+    p[Z] = Dot(poly->Rb[Z], q) + poly->Ob[Z];
+    return;
+}
+void CurrentToBody(const Real p[restrict], const Polyhedron *poly, Real q[restrict])
+{
+    const RealVec D = {p[X] - poly->Ob[X], p[Y] - poly->Ob[Y], p[Z] - poly->Ob[Z]};
+    q[X] = poly->Rb[X][X] * D[X] + poly->Rb[Y][X] * D[Y] + poly->Rb[Z][X] * D[Z];
+    q[Y] = poly->Rb[X][Y] * D[X] + poly->Rb[Y][Y] * D[Y] + poly->Rb[Z][Y] * D[Z];
+    q[Z] = poly->Rb[X][Z] * D[X] + poly->Rb[Y][Z] * D[Y] + poly->Rb[Z][Z] * D[Z];
+    return;
+}
+/*
+ * The mesh is scaled relative to the origin of the body frame, hence the
+ * body frame is placed such that the scaled O is at O before the rotation.
+ */
+void PlacePolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *poly)
 {
-    const RealVec Sin = {sin(angle[X]), sin(angle[Y]), sin(angle[Z])};
-    const RealVec Cos = {cos(angle[X]), cos(angle[Y]), cos(angle[Z])};
-    const Real rotate[DIMS][DIMS] = { /* point rotation matrix */
-        {Cos[Y]*Cos[Z], -Cos[X]*Sin[Z]+Sin[X]*Sin[Y]*Cos[Z], Sin[X]*Sin[Z]+Cos[X]*Sin[Y]*Cos[Z]},
-        {Cos[Y]*Sin[Z], Cos[X]*Cos[Z]+Sin[X]*Sin[Y]*Sin[Z], -Sin[X]*Cos[Z]+Cos[X]*Sin[Y]*Sin[Z]},
-        {-Sin[Y], Sin[X]*Cos[Y], Cos[X]*Cos[Y]}};
-    const Real invrot[DIMS][DIMS] = { /* inverse rotation matrix */
-        {rotate[0][0], rotate[1][0], rotate[2][0]},
-        {rotate[0][1], rotate[1][1], rotate[2][1]},
-        {rotate[0][2], rotate[1][2], rotate[2][2]}};
-    const Real num = 1.0 / sqrt(2.0);
-    const Real axe[6][DIMS] = { /* direction vector of axis xx, yy, zz, xy, yz, zx */
-        {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0},
-        {num, num, 0.0}, {0.0, num, num}, {num, 0.0, num}};
-    RealVec axis = {0.0}; /* direction vector of axis in rotated frame */
-    Real I[6] = {0.0}; /* inertia tensor after rotation */
-    /* transforming vertex and build the new bounding box */
+    const RealVec So = {scale[X] * O[X], scale[Y] * O[Y], scale[Z] * O[Z]};
+    EulerQuaternion(angle, poly->Qb);
+    QuaternionMatrix(poly->Qb, poly->Rb);
     for (int s = 0; s < DIMS; ++s) {
-        poly->box[s][MIN] = FLT_MAX;
-        poly->box[s][MAX] = FLT_MIN;
-    }
-    TransformVertex(O, scale, rotate, offset, poly->box, poly->vertN, poly->v);
-    /* transforming normal assuming pure rotation and translation */
-    TransformNormal(rotate, poly->faceN, poly->Nf);
-    TransformNormal(rotate, poly->edgeN, poly->Ne);
-    TransformNormal(rotate, poly->vertN, poly->Nv);
-    /* transform inertial tensor */
-    for (int n = 0; n < 6; ++n) {
-        axis[X] = Dot(invrot[X], axe[n]);
-        axis[Y] = Dot(invrot[Y], axe[n]);
-        axis[Z] = Dot(invrot[Z], axe[n]);
-        I[n] = TransformInertia(axis, poly->I);
-    }
-    poly->I[X][X] = I[0];  poly->I[X][Y] = -I[3]; poly->I[X][Z] = -I[5];
-    poly->I[Y][X] = -I[3]; poly->I[Y][Y] = I[1];  poly->I[Y][Z] = -I[4];
-    poly->I[Z][X] = -I[5]; poly->I[Z][Y] = -I[4]; poly->I[Z][Z] = I[2];
-    /* centroid should be transformed at last */
-    Real Oc[1][DIMS] = {{poly->O[X], poly->O[Y], poly->O[Z]}};
-    TransformVertex(O, scale, rotate, offset, poly->box, 1, Oc);
-    poly->O[X] = Oc[0][X];
-    poly->O[Y] = Oc[0][Y];
-    poly->O[Z] = Oc[0][Z];
+        poly->Ob[s] = O[s] + offset[s] - Dot(poly->Rb[s], So);
+    }
     return;
 }
-static void TransformVertex(const Real O[restrict], const Real scale[restrict],
-        const Real rotate[restrict][DIMS], const Real offset[restrict],
-        Real box[restrict][LIMIT], const int vertN, Real v[restrict][DIMS])
+/*
+ * The orientation is composed by quaternions and normalized, hence the
+ * rotation of the body frame stays orthonormal over many steps. Then the
+ * body frame follows the centroid, and the inertia tensor and the bounding
+ * box are placed from the body frame. Nothing of the mesh is transformed.
+ */
+void TransformPolyhedron(const Real O[restrict], const Real angle[restrict],
+        const Real offset[restrict], Polyhedron *poly)
 {
+    Real rotate[DIMS][DIMS] = {{0.0}}; /* point rotation matrix */
+    Real dq[4] = {0.0}; /* rotation quaternion */
+    Real Qb[4] = {0.0}; /* orientation before transformation */
     RealVec tmp = {0.0};
-    for (int n = 0; n < vertN; ++n) {
-        /* translate reference frame to a parallel frame at the reference point */
-        v[n][X] = v[n][X] - O[X];
-        v[n][Y] = v[n][Y] - O[Y];
-        v[n][Z] = v[n][Z] - O[Z];
-        /* scale */
-        v[n][X] = v[n][X] * scale[X];
-        v[n][Y] = v[n][Y] * scale[Y];
-        v[n][Z] = v[n][Z] * scale[Z];
-        /* rotate */
-        tmp[X] = v[n][X];
-        tmp[Y] = v[n][Y];
-        tmp[Z] = v[n][Z];
-        v[n][X] = Dot(rotate[X], tmp);
-        v[n][Y] = Dot(rotate[Y], tmp);
-        v[n][Z] = Dot(rotate[Z], tmp);
-        /* translate with offset and then translate reference back to origin */
-        v[n][X] = v[n][X] + offset[X] + O[X];
-        v[n][Y] = v[n][Y] + offset[Y] + O[Y];
-        v[n][Z] = v[n][Z] + offset[Z] + O[Z];
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = (box[s][MIN] < v[n][s]) ? box[s][MIN] : v[n][s];
-            box[s][MAX] = (box[s][MAX] > v[n][s]) ? box[s][MAX] : v[n][s];
-        }
+    VectorQuaternion(angle, dq);
+    QuaternionMatrix(dq, rotate);
+    for (int l = 0; l < 4; ++l) {
+        Qb[l] = poly->Qb[l];
+    }
+    MultiplyQuaternion(dq, Qb, poly->Qb);
+    Normalize(4, sqrt(poly->Qb[0] * poly->Qb[0] + poly->Qb[1] * poly->Qb[1] +
+                poly->Qb[2] * poly->Qb[2] + poly->Qb[3] * poly->Qb[3]), poly->Qb);
+    QuaternionMatrix(poly->Qb, poly->Rb);
+    /* transform centroid */
+    for (int s = 0; s < DIMS; ++s) {
+        tmp[s] = poly->O[s] - O[s];
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        poly->O[s] = Dot(rotate[s], tmp) + offset[s] + O[s];
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        poly->Ob[s] = poly->O[s] - Dot(poly->Rb[s], poly->Om);
     }
+    RotateInertia(poly);
+    BoundBodyBox(poly);
     return;
 }
-static void TransformNormal(const Real matrix[restrict][DIMS],
-        const int normalN, Real N[restrict][DIMS])
+/*
+ * The rotation of Euler angles about x, y, z in turn, which is qz qy qx.
+ */
+static void EulerQuaternion(const Real angle[restrict], Real q[restrict])
 {
-    RealVec tmp = {0.0};
-    for (int n = 0; n < normalN; ++n) {
-        tmp[X] = N[n][X];
-        tmp[Y] = N[n][Y];
-        tmp[Z] = N[n][Z];
-        N[n][X] = Dot(matrix[X], tmp);
-        N[n][Y] = Dot(matrix[Y], tmp);
-        N[n][Z] = Dot(matrix[Z], tmp);
-        /* normalization is needed if anisotropic transformation happens */
+    const RealVec Sin = {sin(0.5 * angle[X]), sin(0.5 * angle[Y]), sin(0.5 * angle[Z])};
+    const RealVec Cos = {cos(0.5 * angle[X]), cos(0.5 * angle[Y]), cos(0.5 * angle[Z])};
+    q[0] = Cos[Z] * Cos[Y] * Cos[X] + Sin[Z] * Sin[Y] * Sin[X];
+    q[1] = Cos[Z] * Cos[Y] * Sin[X] - Sin[Z] * Sin[Y] * Cos[X];
+    q[2] = Cos[Z] * Sin[Y] * Cos[X] + Sin[Z] * Cos[Y] * Sin[X];
+    q[3] = Sin[Z] * Cos[Y] * Cos[X] - Cos[Z] * Sin[Y] * Sin[X];
+    return;
+}
+/*
+ * The rotation of a rotation vector, whose direction is the axis and whose
+ * length is the angle, such as the angular velocity times the time step.
+ */
+static void VectorQuaternion(const Real angle[restrict], Real q[restrict])
+{
+    const Real theta = Norm(angle);
+    q[0] = 1.0;
+    q[1] = 0.0;
+    q[2] = 0.0;
+    q[3] = 0.0;
+    if (0.0 == theta) {
+        return;
     }
+    const Real num = sin(0.5 * theta) / theta;
+    q[0] = cos(0.5 * theta);
+    q[1] = num * angle[X];
+    q[2] = num * angle[Y];
+    q[3] = num * angle[Z];
     return;
 }
-static Real TransformInertia(const Real axis[restrict], Real I[restrict][DIMS])
+static void MultiplyQuaternion(const Real a[restrict], const Real b[restrict], Real c[restrict])
 {
-    return I[X][X] * axis[X] * axis[X] + I[Y][Y] * axis[Y] * axis[Y] +
-        I[Z][Z] * axis[Z] * axis[Z] + 2.0 * I[X][Y] * axis[X] * axis[Y] +
-        2.0 * I[Y][Z] * axis[Y] * axis[Z] + 2.0 * I[Z][X] * axis[Z] * axis[X];
+    c[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    c[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    c[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    c[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+    return;
+}
+static void QuaternionMatrix(const Real q[restrict], Real R[restrict][DIMS])
+{
+    R[X][X] = 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]);
+    R[X][Y] = 2.0 * (q[1] * q[2] - q[0] * q[3]);
+    R[X][Z] = 2.0 * (q[1] * q[3] + q[0] * q[2]);
+    R[Y][X] = 2.0 * (q[1] * q[2] + q[0] * q[3]);
+    R[Y][Y] = 1.0 - 2.0 * (q[1] * q[1] + q[3] * q[3]);
+    R[Y][Z] = 2.0 * (q[2] * q[3] - q[0] * q[1]);
+    R[Z][X] = 2.0 * (q[1] * q[3] - q[0] * q[2]);
+    R[Z][Y] = 2.0 * (q[2] * q[3] + q[0] * q[1]);
+    R[Z][Z] = 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2]);
+    return;
 }
 void ComputeGeometryParameters(const int collapse, Geometry *const geo)
 {
@@ -265,7 +400,13 @@ void ComputeGeometryParameters(const int collapse, Geometry *const geo)
         ComputeParametersSphere(collapse, geo->poly + n);
     }
     for (int n = geo->sphN; n < geo->totN; ++n) {
-        ComputeParametersPolyhedron(collapse, geo->poly + n);
+        Polyhedron *const poly = geo->poly + n;
+        if (n == poly->mesh) {
+            ComputeParametersPolyhedron(collapse, poly);
+        } else {
+            SharePolyhedron(geo->poly + poly->mesh, poly);
+        }
+        PlaceMassProperty(poly);
     }
     return;
 }
@@ -323,7 +464,7 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
     Real box[LIMIT][DIMS] = {{0.0}}; /* bounding box */
     for (int s = 0; s < DIMS; ++s) {
         box[MIN][s] = FLT_MAX;
-        box[MAX][s] = FLT_MIN;
+        box[MAX][s] = -FLT_MAX;
     }
     /* initialize vertices normal */
     memset(poly->Nv, 0, poly->vertN * sizeof(*poly->Nv));
@@ -414,24 +555,20 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         poly->area = area - 2.0 * volume; /* change to side area of a unit thickness polygon */
     }
     poly->volume = volume;
-    poly->O[X] = O[X];
-    poly->O[Y] = O[Y];
-    poly->O[Z] = O[Z];
+    poly->Om[X] = O[X];
+    poly->Om[Y] = O[Y];
+    poly->Om[Z] = O[Z];
     /* inertia relative to centroid */
-    poly->I[X][X] = I[1] + I[2] - volume * (O[Y] * O[Y] + O[Z] * O[Z]);
-    poly->I[X][Y] = -I[3] + volume * O[X] * O[Y];
-    poly->I[X][Z] = -I[5] + volume * O[Z] * O[X];
-    poly->I[Y][X] = poly->I[X][Y];
-    poly->I[Y][Y] = I[0] + I[2] - volume * (O[Z] * O[Z] + O[X] * O[X]);
-    poly->I[Y][Z] = -I[4] + volume * O[Y] * O[Z];
-    poly->I[Z][X] = poly->I[X][Z];
-    poly->I[Z][Y] = poly->I[Y][Z];
-    poly->I[Z][Z] = I[0] + I[1] - volume * (O[X] * O[X] + O[Y] * O[Y]);
-    for (int s = 0; s < DIMS; ++s) {
-        poly->box[s][MIN] = box[MIN][s];
-        poly->box[s][MAX] = box[MAX][s];
-    }
-    /* a radius for estimating maximum velocity */
+    poly->Im[X][X] = I[1] + I[2] - volume * (O[Y] * O[Y] + O[Z] * O[Z]);
+    poly->Im[X][Y] = -I[3] + volume * O[X] * O[Y];
+    poly->Im[X][Z] = -I[5] + volume * O[Z] * O[X];
+    poly->Im[Y][X] = poly->Im[X][Y];
+    poly->Im[Y][Y] = I[0] + I[2] - volume * (O[Z] * O[Z] + O[X] * O[X]);
+    poly->Im[Y][Z] = -I[4] + volume * O[Y] * O[Z];
+    poly->Im[Z][X] = poly->Im[X][Z];
+    poly->Im[Z][Y] = poly->Im[Y][Z];
+    poly->Im[Z][Z] = I[0] + I[1] - volume * (O[X] * O[X] + O[Y] * O[Y]);
+    /* a size of the mesh, the radius is taken once the mesh is placed */
     poly->r = Dist(box[MIN], box[MAX]);
     /* normalize vertices normal */
     for (int n = 0; n < poly->vertN; ++n) {
@@ -444,6 +581,197 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         }
         Normalize(DIMS, Norm(poly->Ne[n]), poly->Ne[n]);
     }
+    BuildBoundingHierarchy(poly);
+    return;
+}
+/*
+ * Properties in the body frame are placed in the current frame. The radius
+ * for estimating maximum velocity is the extent of the placed polyhedron,
+ * hence it depends on the initial rotation as the bounding box does.
+ */
+static void PlaceMassProperty(Polyhedron *poly)
+{
+    BodyToCurrent(poly->Om, poly, poly->O);
+    RotateInertia(poly);
+    BoundPolyhedron(poly);
+    const RealVec pMin = {poly->box[X][MIN], poly->box[Y][MIN], poly->box[Z][MIN]};
+    const RealVec pMax = {poly->box[X][MAX], poly->box[Y][MAX], poly->box[Z][MAX]};
+    poly->r = Dist(pMin, pMax);
+    return;
+}
+/*
+ * The inertia tensor rotates as a tensor, I = Rb Im Rb^T, from the body frame
+ * tensor, which keeps products of inertia exact without round-off build-up.
+ * Note that a moment Id about a diagonal axis, such as (1, 1, 0)/sqrt(2),
+ * is not a product: I[X][Y] = Id - (I[X][X] + I[Y][Y]) / 2.
+ */
+static void RotateInertia(Polyhedron *poly)
+{
+    Real RI[DIMS][DIMS] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        for (int t = 0; t < DIMS; ++t) {
+            RI[s][t] = poly->Rb[s][X] * poly->Im[X][t] + poly->Rb[s][Y] * poly->Im[Y][t] +
+                poly->Rb[s][Z] * poly->Im[Z][t];
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        for (int t = 0; t < DIMS; ++t) {
+            poly->I[s][t] = Dot(RI[s], poly->Rb[t]);
+        }
+    }
+    return;
+}
+static void BoundPolyhedron(Polyhedron *poly)
+{
+    RealVec p = {0.0};
+    for (int s = 0; s < DIMS; ++s) {
+        poly->box[s][MIN] = FLT_MAX;
+        poly->box[s][MAX] = -FLT_MAX;
+    }
+    for (int n = 0; n < poly->vertN; ++n) {
+        BodyToCurrent(poly->v[n], poly, p);
+        for (int s = 0; s < DIMS; ++s) {
+            poly->box[s][MIN] = MinReal(poly->box[s][MIN], p[s]);
+            poly->box[s][MAX] = MaxReal(poly->box[s][MAX], p[s]);
+        }
+    }
+    return;
+}
+/*
+ * The box of the rotated root box of the bounding volume hierarchy, which
+ * encloses the polyhedron at a constant cost.
+ */
+static void BoundBodyBox(Polyhedron *poly)
+{
+    Real (*box)[LIMIT] = poly->bv[0].box;
+    const RealVec c = {0.5 * (box[X][MIN] + box[X][MAX]), 0.5 * (box[Y][MIN] + box[Y][MAX]),
+        0.5 * (box[Z][MIN] + box[Z][MAX])}; /* center in the body frame */
+    const RealVec h = {0.5 * (box[X][MAX] - box[X][MIN]), 0.5 * (box[Y][MAX] - box[Y][MIN]),
+        0.5 * (box[Z][MAX] - box[Z][MIN])}; /* half extent in the body frame */
+    RealVec p = {0.0};
+    BodyToCurrent(c, poly, p);
+    for (int s = 0; s < DIMS; ++s) {
+        const Real e = fabs(poly->Rb[s][X]) * h[X] + fabs(poly->Rb[s][Y]) * h[Y] +
+            fabs(poly->Rb[s][Z]) * h[Z];
+        poly->box[s][MIN] = p[s] - e;
+        poly->box[s][MAX] = p[s] + e;
+    }
+    return;
+}
+/*
+ * The bounding volume hierarchy is built top-down by splitting the faces at
+ * the median centroid along the longest extent of their centroids, hence it
+ * is balanced with leaves of at most BVLEAF faces. It is built on the mesh
+ * in the body frame; rigid motions only transform the body frame. Boxes are
+ * padded by a small fraction of the polyhedron size to absorb the round-off
+ * between lines mapped into the body frame and faces mapped into the current
+ * frame, so that the pruning is conservative.
+ */
+static void BuildBoundingHierarchy(Polyhedron *poly)
+{
+    RetrieveStorage(poly->bv);
+    RetrieveStorage(poly->bf);
+    poly->bv = AssignStorage(2 * poly->faceN * sizeof(*poly->bv), MEMGEOMETRY);
+    poly->bf = AssignStorage(poly->faceN * sizeof(*poly->bf), MEMGEOMETRY);
+    Real (*cen)[DIMS] = AssignStorage(poly->faceN * sizeof(*cen), MEMSCRATCH); /* face centroids */
+    for (int n = 0; n < poly->faceN; ++n) {
+        poly->bf[n] = n;
+        for (int s = 0; s < DIMS; ++s) {
+            cen[n][s] = (poly->v[poly->f[n][0]][s] + poly->v[poly->f[n][1]][s] +
+                    poly->v[poly->f[n][2]][s]) * (1.0 / 3.0);
+        }
+    }
+    poly->nodeN = 0;
+    BuildBoundingNode(0, poly->faceN, cen, poly);
+    RetrieveStorage(cen);
+    return;
+}
+static int BuildBoundingNode(const int m, const int n, Real cen[restrict][DIMS], Polyhedron *poly)
+{
+    const int node = poly->nodeN;
+    const Real pad = 1.0e-6 * poly->r;
+    Real box[DIMS][LIMIT] = {{0.0}}; /* centroid box */
+    BvNode *const bv = poly->bv + node;
+    ++(poly->nodeN);
+    for (int s = 0; s < DIMS; ++s) {
+        bv->box[s][MIN] = FLT_MAX;
+        bv->box[s][MAX] = -FLT_MAX;
+        box[s][MIN] = FLT_MAX;
+        box[s][MAX] = -FLT_MAX;
+    }
+    for (int l = m; l < n; ++l) {
+        const int f = poly->bf[l];
+        for (int s = 0; s < DIMS; ++s) {
+            for (int v = 0; v < POLYN; ++v) {
+                bv->box[s][MIN] = MinReal(bv->box[s][MIN], poly->v[poly->f[f][v]][s]);
+                bv->box[s][MAX] = MaxReal(bv->box[s][MAX], poly->v[poly->f[f][v]][s]);
+            }
+            box[s][MIN] = MinReal(box[s][MIN], cen[f][s]);
+            box[s][MAX] = MaxReal(box[s][MAX], cen[f][s]);
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        bv->box[s][MIN] = bv->box[s][MIN] - pad;
+        bv->box[s][MAX] = bv->box[s][MAX] + pad;
+    }
+    bv->fm = m;
+    bv->fn = n;
+    bv->next = NONE;
+    if (BVLEAF >= n - m) {
+        return node;
+    }
+    int axis = X;
+    for (int s = Y; s < DIMS; ++s) {
+        if (box[s][MAX] - box[s][MIN] > box[axis][MAX] - box[axis][MIN]) {
+            axis = s;
+        }
+    }
+    const int k = (m + n) / 2;
+    SelectFace(k, axis, m, n, cen, poly->bf);
+    BuildBoundingNode(m, k, cen, poly);
+    bv->next = BuildBoundingNode(k, n, cen, poly);
+    return node;
+}
+/*
+ * Partially order faces in [m, n) by their centroids along axis s, such
+ * that the k-th face is in place with no greater faces before it and no
+ * smaller faces after it.
+ */
+static void SelectFace(const int k, const int s, const int m, const int n,
+        Real cen[restrict][DIMS], int bf[restrict])
+{
+    int lo = m;
+    int hi = n - 1;
+    int temp = 0;
+    while (lo < hi) {
+        const Real pivot = cen[bf[(lo + hi) / 2]][s];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (cen[bf[i]][s] < pivot) {
+                ++i;
+            }
+            while (cen[bf[j]][s] > pivot) {
+                --j;
+            }
+            if (i <= j) {
+                temp = bf[i];
+                bf[i] = bf[j];
+                bf[j] = temp;
+                ++i;
+                --j;
+            }
+        }
+        if (k <= j) {
+            hi = j;
+        } else {
+            if (k >= i) {
+                lo = i;
+            } else {
+                break;
+            }
+        }
+    }
     return;
 }
 void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
@@ -461,6 +789,12 @@ void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
     return;
 }
 int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[restrict])
+{
+    RealVec q = {0.0}; /* query point in the body frame */
+    CurrentToBody(p, poly, q);
+    return PointInBody(q, poly, fid);
+}
+static int PointInBody(const Real q[restrict], const Polyhedron *poly, int fid[restrict])
 {
     const Real zero = 0.0;
     RealVec v0 = {zero}; /* vertices */
@@ -483,19 +817,52 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     Real distSquare = zero; /* store computed squared distance */
     Real distSquareMin = FLT_MAX; /* store minimum squared distance */
     int cid = 0; /* closest face identifier */
-    for (int n = 0; n < poly->faceN; ++n) {
-        BuildTriangle(n, poly, v0, v1, v2, e01, e02);
-        distSquare = PointTriangleDistance(p, v0, e01, e02, para);
-        if (distSquareMin > distSquare) {
-            distSquareMin = distSquare;
-            cid = n;
+    /*
+     * Traverse the bounding volume hierarchy nearer child first, and prune
+     * nodes farther than the closest face found. Ties are resolved to the
+     * smallest face identifier as a linear search over all faces does.
+     */
+    if (NULL != poly->gd) {
+        const int in = LookupDistanceGrid(q, poly, fid);
+        if (NONE != in) {
+            return in;
         }
     }
+    int stack[BVDEPTH] = {0}; /* nodes to visit */
+    int top = 1;
+    while (0 < top) {
+        --top;
+        const int node = stack[top];
+        BvNode *const bv = poly->bv + node;
+        if (distSquareMin < BoxDistance(q, bv->box)) {
+            continue;
+        }
+        if (NONE == bv->next) { /* leaf */
+            for (int l = bv->fm; l < bv->fn; ++l) {
+                const int n = poly->bf[l];
+                BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+                distSquare = PointTriangleDistance(q, v0, e01, e02, para);
+                if ((distSquareMin > distSquare) || ((distSquareMin == distSquare) && (cid > n))) {
+                    distSquareMin = distSquare;
+                    cid = n;
+                }
+            }
+            continue;
+        }
+        if (BoxDistance(q, poly->bv[node+1].box) <= BoxDistance(q, poly->bv[bv->next].box)) {
+            stack[top] = bv->next;
+            stack[top+1] = node + 1;
+        } else {
+            stack[top] = node + 1;
+            stack[top+1] = bv->next;
+        }
+        top = top + 2;
+    }
     *fid = cid;
-    ComputeIntersection(p, cid, poly, pi, N);
-    pi[X] = p[X] - pi[X];
-    pi[Y] = p[Y] - pi[Y];
-    pi[Z] = p[Z] - pi[Z];
+    IntersectFace(q, cid, poly, pi, N);
+    pi[X] = q[X] - pi[X];
+    pi[Y] = q[Y] - pi[Y];
+    pi[Z] = q[Z] - pi[Z];
     if (zero < Dot(pi, N)) {
         /* outside polyhedron */
         return 0;
@@ -504,6 +871,239 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
         return 1;
     }
 }
+/*
+ * The signed distance is tabulated at grid nodes by exact queries. Since a
+ * distance function has a unit Lipschitz constant, the trilinear value of a
+ * cell differs from the exact distance by at most the cell diagonal, which
+ * the band exceeds; hence the sign is exact outside the band. The closest
+ * face is taken from the nearest grid node. On a collapsed dimension, the
+ * body is an extruded polygon and nodes beyond its extent are outside, thus
+ * the grid only spans the extent and one cell more on each side.
+ */
+void ComputeDistanceGrid(const Real h, const Real band, const int flat[restrict], Polyhedron *poly)
+{
+    RetrieveStorage(poly->gd);
+    RetrieveStorage(poly->gf);
+    poly->gd = NULL; /* queries building the grid are exact */
+    poly->gf = NULL;
+    poly->gh = h;
+    poly->band = band;
+    for (int s = 0; s < DIMS; ++s) {
+        const Real pad = (0 != flat[s]) ? h : band + h; /* margin around the body */
+        poly->gO[s] = poly->bv[0].box[s][MIN] - pad;
+        poly->gn[s] = (int)((poly->bv[0].box[s][MAX] + pad - poly->gO[s]) / h) + 2;
+    }
+    const size_t nodeN = (size_t)poly->gn[X] * poly->gn[Y] * poly->gn[Z];
+    Real *gd = AssignStorage(nodeN * sizeof(*gd), MEMGEOMETRY);
+    int *gf = AssignStorage(nodeN * sizeof(*gf), MEMGEOMETRY);
+    #pragma omp parallel for collapse(3) schedule(dynamic, 64)
+    for (int k = 0; k < poly->gn[Z]; ++k) {
+        for (int j = 0; j < poly->gn[Y]; ++j) {
+            for (int i = 0; i < poly->gn[X]; ++i) {
+                const size_t idx = ((size_t)k * poly->gn[Y] + j) * poly->gn[X] + i;
+                const RealVec q = {poly->gO[X] + i * h, poly->gO[Y] + j * h, poly->gO[Z] + k * h};
+                RealVec pi = {0.0};
+                RealVec N = {0.0};
+                int fid = 0;
+                const int in = PointInBody(q, poly, &fid);
+                const Real dist = sqrt(IntersectFace(q, fid, poly, pi, N));
+                gd[idx] = (0 != in) ? -dist : dist;
+                gf[idx] = fid;
+            }
+        }
+    }
+    poly->gd = gd;
+    poly->gf = gf;
+    return;
+}
+void ShareDistanceGrid(const Polyhedron *src, Polyhedron *poly)
+{
+    poly->gh = src->gh;
+    poly->band = src->band;
+    poly->gd = src->gd;
+    poly->gf = src->gf;
+    for (int s = 0; s < DIMS; ++s) {
+        poly->gn[s] = src->gn[s];
+        poly->gO[s] = src->gO[s];
+    }
+    return;
+}
+/*
+ * Return the inclusion of a body-frame point and its closest face from the
+ * distance grid, or NONE if the point is within the band.
+ */
+static int LookupDistanceGrid(const Real q[restrict], const Polyhedron *poly, int fid[restrict])
+{
+    IntVec n = {0}; /* lower node of the cell */
+    RealVec w = {0.0}; /* local coordinates in the cell */
+    for (int s = 0; s < DIMS; ++s) {
+        const Real x = (q[s] - poly->gO[s]) / poly->gh;
+        if ((0.0 > x) || (poly->gn[s] - 1 <= x)) {
+            return 0; /* out of the grid, which is outside the band */
+        }
+        n[s] = (int)x;
+        w[s] = x - n[s];
+    }
+    const size_t sj = poly->gn[X];
+    const size_t sk = sj * poly->gn[Y];
+    const size_t idx = n[Z] * sk + n[Y] * sj + n[X];
+    const Real *const gd = poly->gd;
+    const Real dist =
+        (1.0 - w[Z]) * ((1.0 - w[Y]) * ((1.0 - w[X]) * gd[idx] + w[X] * gd[idx+1]) +
+                w[Y] * ((1.0 - w[X]) * gd[idx+sj] + w[X] * gd[idx+sj+1])) +
+        w[Z] * ((1.0 - w[Y]) * ((1.0 - w[X]) * gd[idx+sk] + w[X] * gd[idx+sk+1]) +
+                w[Y] * ((1.0 - w[X]) * gd[idx+sk+sj] + w[X] * gd[idx+sk+sj+1]));
+    if (poly->band > fabs(dist)) {
+        return NONE;
+    }
+    *fid = poly->gf[(n[Z] + (0.5 < w[Z])) * sk + (n[Y] + (0.5 < w[Y])) * sj + n[X] + (0.5 < w[X])];
+    return (0.0 > dist) ? 1 : 0;
+}
+/*
+ * The line is traversed on the bounding volume hierarchy in the body frame,
+ * and faces mapped into the current frame are tested by the barycentric
+ * coordinates of the line in the projection along x.
+ *
+ * Inclusion tests of points within round-off of the surface are not robust,
+ * thus crossings only infer the inclusion of nodes clearly away from the
+ * surface. A line grazes the surface if it passes within a tolerance of the
+ * boundary of a projected face, or crosses a face so obliquely that nodes
+ * farther than the node spacing h from the crossing can still be within the
+ * tolerance of the face. Nothing is inferred for a grazing line.
+ */
+int LineCrossPolyhedron(const Real p[restrict], const Real h, const Polyhedron *poly,
+        const int max, Real x[restrict])
+{
+    const Real tol = 1.0e-6 * poly->r; /* tolerance of grazing */
+    RealVec q = {0.0}; /* line point in the body frame */
+    CurrentToBody(p, poly, q);
+    const RealVec u = {poly->Rb[X][X], poly->Rb[X][Y], poly->Rb[X][Z]}; /* line direction in the body frame */
+    int stack[BVDEPTH] = {0}; /* nodes to visit */
+    int top = 1;
+    int crossN = 0;
+    Real xc = 0.0;
+    while (0 < top) {
+        --top;
+        const int node = stack[top];
+        BvNode *const bv = poly->bv + node;
+        if (!LineHitBox(q, u, bv->box)) {
+            continue;
+        }
+        if (NONE == bv->next) { /* leaf */
+            for (int l = bv->fm; l < bv->fn; ++l) {
+                const int cross = LineCrossTriangle(p, poly->bf[l], tol, tol / h, poly, &xc);
+                if (NONE == cross) {
+                    return NONE;
+                }
+                if (0 != cross) {
+                    if (max > crossN) {
+                        x[crossN] = xc;
+                    }
+                    ++crossN;
+                }
+            }
+            continue;
+        }
+        stack[top] = bv->next;
+        stack[top+1] = node + 1;
+        top = top + 2;
+    }
+    /* sort crossings by insertion */
+    for (int m = 1; m < MinInt(crossN, max); ++m) {
+        xc = x[m];
+        int l = m;
+        while ((0 < l) && (x[l-1] > xc)) {
+            x[l] = x[l-1];
+            --l;
+        }
+        x[l] = xc;
+    }
+    return crossN;
+}
+static int LineHitBox(const Real q[restrict], const Real u[restrict], Real box[restrict][LIMIT])
+{
+    Real tMin = -FLT_MAX;
+    Real tMax = FLT_MAX;
+    for (int s = 0; s < DIMS; ++s) {
+        if (FLT_EPSILON > fabs(u[s])) { /* parallel to the slab */
+            if ((box[s][MIN] > q[s]) || (box[s][MAX] < q[s])) {
+                return 0;
+            }
+            continue;
+        }
+        const Real t0 = (box[s][MIN] - q[s]) / u[s];
+        const Real t1 = (box[s][MAX] - q[s]) / u[s];
+        tMin = MaxReal(tMin, MinReal(t0, t1));
+        tMax = MinReal(tMax, MaxReal(t0, t1));
+        if (tMin > tMax) {
+            return 0;
+        }
+    }
+    return 1;
+}
+/*
+ * Return 1 if the line crosses the face, 0 if it misses, and NONE if it
+ * grazes. The doubled signed areas of the projected sub-triangles divided by
+ * the projected edge lengths are the distances to the projected edges.
+ */
+static int LineCrossTriangle(const Real p[restrict], const int fid, const Real tol, const Real slope,
+        const Polyhedron *poly, Real xc[restrict])
+{
+    RealVec a = {0.0}; /* vertices in the current frame */
+    RealVec b = {0.0};
+    RealVec c = {0.0};
+    BodyToCurrent(poly->v[poly->f[fid][0]], poly, a);
+    BodyToCurrent(poly->v[poly->f[fid][1]], poly, b);
+    BodyToCurrent(poly->v[poly->f[fid][2]], poly, c);
+    Real wa = (b[Y] - p[Y]) * (c[Z] - p[Z]) - (b[Z] - p[Z]) * (c[Y] - p[Y]);
+    Real wb = (c[Y] - p[Y]) * (a[Z] - p[Z]) - (c[Z] - p[Z]) * (a[Y] - p[Y]);
+    Real wc = (a[Y] - p[Y]) * (b[Z] - p[Z]) - (a[Z] - p[Z]) * (b[Y] - p[Y]);
+    Real sum = wa + wb + wc;
+    if (0.0 > sum) {
+        wa = -wa;
+        wb = -wb;
+        wc = -wc;
+        sum = -sum;
+    }
+    const RealVec e01 = {b[X] - a[X], b[Y] - a[Y], b[Z] - a[Z]};
+    const RealVec e02 = {c[X] - a[X], c[Y] - a[Y], c[Z] - a[Z]};
+    RealVec N = {0.0};
+    Cross(e01, e02, N);
+    if (slope * Norm(N) >= sum) { /* a face nearly parallel to the line */
+        const Real yMin = MinReal(a[Y], MinReal(b[Y], c[Y])) - tol;
+        const Real yMax = MaxReal(a[Y], MaxReal(b[Y], c[Y])) + tol;
+        const Real zMin = MinReal(a[Z], MinReal(b[Z], c[Z])) - tol;
+        const Real zMax = MaxReal(a[Z], MaxReal(b[Z], c[Z])) + tol;
+        if ((yMin <= p[Y]) && (yMax >= p[Y]) && (zMin <= p[Z]) && (zMax >= p[Z])) {
+            return NONE;
+        }
+        return 0;
+    }
+    const Real da = wa / sqrt((c[Y] - b[Y]) * (c[Y] - b[Y]) + (c[Z] - b[Z]) * (c[Z] - b[Z]));
+    const Real db = wb / sqrt((a[Y] - c[Y]) * (a[Y] - c[Y]) + (a[Z] - c[Z]) * (a[Z] - c[Z]));
+    const Real dc = wc / sqrt((b[Y] - a[Y]) * (b[Y] - a[Y]) + (b[Z] - a[Z]) * (b[Z] - a[Z]));
+    if ((-tol > da) || (-tol > db) || (-tol > dc)) {
+        return 0;
+    }
+    if ((tol >= da) || (tol >= db) || (tol >= dc)) {
+        return NONE;
+    }
+    *xc = (wa * a[X] + wb * b[X] + wc * c[X]) / sum;
+    return 1;
+}
+static Real BoxDistance(const Real p[restrict], Real box[restrict][LIMIT])
+{
+    Real distSquare = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        if (box[s][MIN] > p[s]) {
+            distSquare = distSquare + (box[s][MIN] - p[s]) * (box[s][MIN] - p[s]);
+        }
+        if (box[s][MAX] < p[s]) {
+            distSquare = distSquare + (p[s] - box[s][MAX]) * (p[s] - box[s][MAX]);
+        }
+    }
+    return distSquare;
+}
 /*
  * Eberly, D. (1999). Distance between point and triangle in 3D.
  * http://www.geometrictools.com/Documentation/DistancePoint3Triangle3.pdf
@@ -686,8 +1286,26 @@ Real PointTriangleDistance(const Real p[restrict], const Real v0[restrict], cons
     }
     return distSquare;
 }
+/*
+ * The point is mapped into the body frame, and the intersection point and
+ * normal found on the mesh are mapped back.
+ */
 Real ComputeIntersection(const Real p[restrict], const int fid,
         const Polyhedron *poly, Real pi[restrict], Real N[restrict])
+{
+    RealVec q = {0.0};
+    RealVec qi = {0.0};
+    RealVec Nb = {0.0};
+    CurrentToBody(p, poly, q);
+    const Real distSquare = IntersectFace(q, fid, poly, qi, Nb);
+    BodyToCurrent(qi, poly, pi);
+    N[X] = Dot(poly->Rb[X], Nb);
+    N[Y] = Dot(poly->Rb[Y], Nb);
+    N[Z] = Dot(poly->Rb[Z], Nb);
+    return distSquare;
+}
+static Real IntersectFace(const Real p[restrict], const int fid,
+        const Polyhedron *poly, Real pi[restrict], Real N[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
@@ -33,10 +33,28 @@
 extern void ConvertPolyhedron(Polyhedron *);
 extern void AllocatePolyhedronMemory(const int vertN, const int edgeN,
         const int faceN, Polyhedron *);
-extern void AddEdge(const int v0, const int v1, const int f, Polyhedron *);
-extern void QuickSortEdge(const int n, int e[restrict][EVF]);
+extern void BuildEdge(Polyhedron *);
 extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict]);
+/*
+ * Polyhedron instancing
+ *
+ * Function
+ *      A converted mesh is immutable and defines the body frame, which is
+ *      placed in the current frame by the rotation Rb and the origin Ob of
+ *      each instance. Share the mesh and its derived data of the owner src
+ *      with an instance. Scale the vertices of an owned mesh.
+ */
+extern void SharePolyhedron(const Polyhedron *src, Polyhedron *);
+extern void ScalePolyhedron(const Real scale[restrict], Polyhedron *);
+/*
+ * Frame mapping
+ *
+ * Function
+ *      Map a point between the body frame and the current frame.
+ */
+extern void BodyToCurrent(const Real q[restrict], const Polyhedron *, Real p[restrict]);
+extern void CurrentToBody(const Real p[restrict], const Polyhedron *, Real q[restrict]);
 /*
  * Compute geometry parameters
  *
@@ -45,21 +63,69 @@ extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
  *      volume, area, volume, centroid, inertia tensor, normal. Note that the
  *      inertia tensor is relative to the body coordinates located at centroid
  *      and is computed by assuming that the density is a constant with value 1.
+ *      Properties of a shared mesh are computed once by its owner in the body
+ *      frame, and placed in the current frame for each instance.
  */
 extern void ComputeGeometryParameters(const int collapse, Geometry *const);
 /*
  * Polyhedron transformation
+ *
+ * Function
+ *      Place an instance of a mesh scaled by scale at the state of scaling
+ *      relative to O, then rotating by Euler angles about x, y, z in turn
+ *      relative to O, and translating by offset. Transform the placement of
+ *      a polyhedron by a rotation vector angle relative to O and a
+ *      translation at a constant cost, which leaves the mesh untouched and
+ *      keeps a bounding box of the polyhedron.
+ *      The angle is read differently by the two functions. PlacePolyhedron
+ *      reads Euler angles about x, y, z in turn, as the rotate entries of a
+ *      polyhedron transform in the geometry file. TransformPolyhedron reads
+ *      a rotation vector, whose direction is the axis and whose length is
+ *      the angle, as the increment W*dt of a moving polyhedron.
  */
-extern void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
+extern void PlacePolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *);
+extern void TransformPolyhedron(const Real O[restrict], const Real angle[restrict],
+        const Real offset[restrict], Polyhedron *);
 /*
  * Point in polyhedron
  *
  * Function
  *      Solve point-in-polyhedron problem for triangulated polyhedron,
- *      also find the cloest face.
+ *      also find the cloest face. The point is mapped into the body frame,
+ *      and the closest face is searched on the bounding volume hierarchy
+ *      of the mesh, which is built by ComputeGeometryParameters and is
+ *      shared by instances without rebuilding.
  */
 extern int PointInPolyhedron(const Real p[restrict], const Polyhedron *, int fid[restrict]);
+/*
+ * Line polyhedron crossing
+ *
+ * Function
+ *      Find the crossings of the line through p along x with the faces of
+ *      a triangulated polyhedron, store the x coordinates of at most max of
+ *      them in ascending order, and return the number of crossings. Return
+ *      NONE if the line grazes the surface, such that nodes spaced by h on
+ *      the line cannot be classified by crossings.
+ */
+extern int LineCrossPolyhedron(const Real p[restrict], const Real h, const Polyhedron *,
+        const int max, Real x[restrict]);
+/*
+ * Distance grid
+ *
+ * Function
+ *      Tabulate the signed distance and the closest face of a triangulated
+ *      polyhedron on a uniform grid of spacing h in its body frame. Then,
+ *      point-in-polyhedron queries farther than band from the surface are
+ *      answered by a trilinear lookup; closer queries remain exact. The band
+ *      should exceed the grid cell diagonal. Dimensions flagged by flat are
+ *      collapsed, on which the grid spans the polyhedron without the band.
+ *      Share the grid of the owner src with an instance, which keeps its
+ *      own placed mass properties.
+ */
+extern void ComputeDistanceGrid(const Real h, const Real band, const int flat[restrict],
+        Polyhedron *);
+extern void ShareDistanceGrid(const Polyhedron *src, Polyhedron *);
 /*
  * Point triangle distance
  *
@@ -74,7 +140,7 @@ extern Real PointTriangleDistance(const Real p[restrict], const Real v0[restrict
  *
  * Function
  *      Obtain the coordinates and normal of the intersection point,
- *      also return the distance.
+ *      also return the squared distance. Points are in the current frame.
  */
 extern Real ComputeIntersection(const Real p[restrict], const int fid,
         const Polyhedron *poly, Real pi[restrict], Real N[restrict]);
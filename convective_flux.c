@@ -26,11 +26,15 @@ typedef enum {
  * Function Pointers
  ****************************************************************************/
 typedef void (*FhatReconstructor)(Real [restrict][DIMU], Real [restrict]);
+typedef void (*FhatBatchReconstructor)(const int, const int, Real [restrict][WENOLANE], Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void DecomposeFlux(const int, const int, const int, const int, const int,
+        const int [restrict], const Field *const, const Model *,
+        Real [restrict][DIMU], Real [restrict][DIMU], Real [restrict][DIMU]);
 static void CharacteristicVariable(const int, const int, const int, const int,
-        const int, const int, const int, const int [restrict], const Node *const,
+        const int, const int, const int, const int [restrict], const Field *const,
         Real [restrict][DIMU], Real [restrict][DIMU]);
 static void CharacteristicFlux(const Real [restrict], Real [restrict][DIMU],
         const int, const int, const int,  Real [restrict][DIMU]);
@@ -42,22 +46,84 @@ static void InverseProjection(Real [restrict][DIMU], const Real [restrict],
 static FhatReconstructor ReconstructFhat[2] = {
     WENO3,
     WENO5};
+static FhatBatchReconstructor ReconstructFhatBatch[2] = {
+    WENO3Batch,
+    WENO5Batch};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void ComputeFhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+        const int stride[restrict], const Field *const field, const Model *model, Real Fhat[restrict])
+{
+    Real R[DIMU][DIMU]; /* vector space {Rn} */
+    Real HP[FDN][DIMU]; /* forward characteristic flux stencil */
+    Real HN[FDN][DIMU]; /* backward characteristic flux stencil */
+    DecomposeFlux(tn, s, k, j, i, stride, field, model, R, HP, HN);
+    /* WENO reconstruction */
+    Real HhatP[DIMU]; /* forward numerical flux of characteristic fields */
+    Real HhatN[DIMU]; /* backward numerical flux of characteristic fields */
+    ReconstructFhat[model->sScheme](HP, HhatP);
+    ReconstructFhat[model->sScheme](HN, HhatN);
+    /* inverse projection */
+    InverseProjection(R, HhatP, HhatN, Fhat);
+    return;
+}
+/*
+ * The characteristic fields of a batch are laid out as lanes: interface q
+ * occupies lanes [2q * DIMU, 2q * DIMU + DIMU) for the forward fields and
+ * the next DIMU lanes for the backward fields.
+ */
+void ComputeFhatBatch(const int tn, const int s, const int k, const int j, const int i,
+        const int batchN, const int stride[restrict], const Field *const field,
+        const Model *model, Real Fhat[restrict][DIMU])
 {
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    const int idxL = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxR = IndexNode(k + h[s][Z], j + h[s][Y], i + h[s][X], partn[Y], partn[X]);
+    const int tot = model->sR - model->sL; /* width of the direct stencil */
+    const int laneN = 2 * DIMU * batchN;
+    Real R[WENOBATCH][DIMU][DIMU]; /* vector space {Rn} of each interface */
+    Real H[FDN][WENOLANE]; /* characteristic flux stencils of all lanes */
+    Real Hhat[WENOLANE]; /* numerical flux of characteristic fields of all lanes */
+    for (int q = 0; q < batchN; ++q) {
+        Real HP[FDN][DIMU]; /* forward characteristic flux stencil */
+        Real HN[FDN][DIMU]; /* backward characteristic flux stencil */
+        DecomposeFlux(tn, s, k + q * h[s][Z], j + q * h[s][Y], i + q * h[s][X],
+                stride, field, model, R[q], HP, HN);
+        for (int m = 0; m < tot; ++m) {
+            for (int r = 0; r < DIMU; ++r) {
+                H[m][2*q*DIMU+r] = HP[m][r];
+                H[m][2*q*DIMU+DIMU+r] = HN[m][r];
+            }
+        }
+    }
+    /* WENO reconstruction */
+    ReconstructFhatBatch[model->sScheme](model->isa, laneN, H, Hhat);
+    /* inverse projection */
+    for (int q = 0; q < batchN; ++q) {
+        InverseProjection(R[q], Hhat + 2 * q * DIMU, Hhat + 2 * q * DIMU + DIMU, Fhat[q]);
+    }
+    return;
+}
+/*
+ * Local characteristic decomposition of the flux at the interface at the
+ * right of node (k, j, i).
+ */
+static void DecomposeFlux(const int tn, const int s, const int k, const int j, const int i,
+        const int stride[restrict], const Field *const field, const Model *model,
+        Real R[restrict][DIMU], Real HP[restrict][DIMU], Real HN[restrict][DIMU])
+{
+    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
+    const int idxL = IndexStride(k, j, i, stride);
+    const int idxR = IndexStride(k + h[s][Z], j + h[s][Y], i + h[s][X], stride);
     /* evaluate interface values by averaging */
+    Real UL[DIMU]; /* left state */
+    Real UR[DIMU]; /* right state */
     Real Uo[DIMUo]; /* store averaged primitives */
-    SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
+    GatherU(idxL, field->U[tn], UL);
+    GatherU(idxR, field->U[tn], UR);
+    SymmetricAverage(model->jacobMean, model->gamma, UL, UR, Uo);
     /* decompose Jacobian matrix */
     Real Lambda[DIMU]; /* eigenvalues */
     Real L[DIMU][DIMU]; /* vector space {Ln} */
-    Real R[DIMU][DIMU]; /* vector space {Rn} */
     Eigenvalue(s, Uo, Lambda);
     EigenvectorL(s, model->gamma, Uo, L);
     EigenvectorR(s, Uo, R);
@@ -67,35 +133,25 @@ void ComputeFhat(const int tn, const int s, const int k, const int j, const int
     EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
     /* construct local characteristic variables for all potential stencils */
     Real W[FTN][DIMU];
-    CharacteristicVariable(tn, s, k, j, i, model->sL, model->sR, partn, node, L, W);
+    CharacteristicVariable(tn, s, k, j, i, model->sL, model->sR, stride, field, L, W);
     /* construct local characteristic fluxes */
-    Real HP[FDN][DIMU]; /* forward characteristic flux stencil */
-    Real HN[FDN][DIMU]; /* backward characteristic flux stencil */
     CharacteristicFlux(LambdaP, W, 0, +1, model->sR - model->sL, HP);
     CharacteristicFlux(LambdaN, W, model->sR - model->sL, -1, model->sR - model->sL, HN);
-    /* WENO reconstruction */
-    Real HhatP[DIMU]; /* forward numerical flux of characteristic fields */
-    Real HhatN[DIMU]; /* backward numerical flux of characteristic fields */
-    ReconstructFhat[model->sScheme](HP, HhatP);
-    ReconstructFhat[model->sScheme](HN, HhatN);
-    /* inverse projection */
-    InverseProjection(R, HhatP, HhatN, Fhat);
     return;
 }
 static void CharacteristicVariable(const int tn, const int s, const int k, const int j,
-        const int i, const int sL, const int sR, const int partn[restrict],
-        const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
+        const int i, const int sL, const int sR, const int stride[restrict],
+        const Field *const field, Real L[restrict][DIMU], Real W[restrict][DIMU])
 {
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
     int idx = 0; /* linear array index math variable */
-    const Real *restrict U = NULL;
+    FdReal *const *const U = field->U[tn];
     for (int n = sL, m = 0; n <= sR; ++n, ++m) {
-        idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
+        idx = IndexStride(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], stride);
         for (int r = 0; r < DIMU; ++r) {
             W[m][r] = 0.0;
             for (int c = 0; c < DIMU; ++c) {
-                W[m][r] = W[m][r] + L[r][c] * U[c];
+                W[m][r] = W[m][r] + L[r][c] * U[c][idx];
             }
         }
     }
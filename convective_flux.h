@@ -27,11 +27,24 @@
  * Convective flux
  *
  * Function
- *      reconstruct the numerical convective flux.
+ *      reconstruct the numerical convective flux. Nodes are located in
+ *      the field arrays by the strides of the node space (see IndexStride).
  */
 extern void ComputeFhat(const int tn, const int s, const int k, const int j,
-        const int i, const int partn[restrict], const Node *const,
+        const int i, const int stride[restrict], const Field *const,
         const Model *, Real Fhat[restrict]);
+/*
+ * Batched convective flux
+ *
+ * Function
+ *      reconstruct the numerical convective fluxes of batchN (at most
+ *      WENOBATCH) successive interfaces along direction s, starting from
+ *      the interface at the right of node (k, j, i), and store them as
+ *      Fhat[interface][DIMU]. Results are identical to ComputeFhat.
+ */
+extern void ComputeFhatBatch(const int tn, const int s, const int k, const int j,
+        const int i, const int batchN, const int stride[restrict], const Field *const,
+        const Model *, Real Fhat[restrict][DIMU]);
 #endif
 /* a good practice: end file with a newline */
 
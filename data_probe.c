@@ -14,7 +14,7 @@
 #include "data_probe.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* support for abs operation */
-#include "computational_geometry.h"
+#include "message_passing.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -28,30 +28,36 @@ void WritePointProbeData(const Time *time, const Space *space, const Model *mode
     FILE *fp = NULL;
     String fname = {'\0'};
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     int idx = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
-    const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    /* probes are confined to the entire domain, then picked by the owning partition */
+    const IntVec nMin = {n0[X], n0[Y], n0[Z]};
+    const IntVec nMax = {n0[X] + part->mt[X] + 1, n0[Y] + part->mt[Y] + 1, n0[Z] + part->mt[Z] + 1};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
     RealVec p1 = {0.0};
     int i = 0, j = 0, k = 0;
     for (int n = 0; n < time->dataN[PROPT]; ++n) {
+        p1[X] = time->pp[n][0];
+        p1[Y] = time->pp[n][1];
+        p1[Z] = time->pp[n][2];
+        i = ConfineSpace(MapNode(p1[X], sMin[X], dd[X], n0[X]), nMin[X], nMax[X]);
+        j = ConfineSpace(MapNode(p1[Y], sMin[Y], dd[Y], n0[Y]), nMin[Y], nMax[Y]);
+        k = ConfineSpace(MapNode(p1[Z], sMin[Z], dd[Z], n0[Z]), nMin[Z], nMax[Z]);
+        if (!InPartBox(k, j, i, part->ns[PHY])) { /* probe owned by other partitions */
+            continue;
+        }
         snprintf(fname, sizeof(fname), "%s%03d.csv", "point_probe_", n + 1);
         fp = Fopen(fname, "a");
         if (0 == time->stepC) { /* initialization step */
             fprintf(fp, "# time, rho, u, v, w, p, T\n");
         }
-        p1[X] = time->pp[n][0];
-        p1[Y] = time->pp[n][1];
-        p1[Z] = time->pp[n][2];
-        i = ConfineSpace(MapNode(p1[X], sMin[X], dd[X], ng[X]), nMin[X], nMax[X]);
-        j = ConfineSpace(MapNode(p1[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
-        k = ConfineSpace(MapNode(p1[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-        MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+        GatherU(idx, field->U[TO], U);
+        MapPrimitive(model->gamma, model->gasR, U, Uo);
         fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                 time->now, Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         fclose(fp);
@@ -66,25 +72,25 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
     FILE *fp = NULL;
     String fname = {'\0'};
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     int idx = 0; /* linear array index math variable */
     int idxOld = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
-    const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    /* probes are confined to the entire domain, then picked by the owning partition */
+    const IntVec nMin = {n0[X], n0[Y], n0[Z]};
+    const IntVec nMax = {n0[X] + part->mt[X] + 1, n0[Y] + part->mt[Y] + 1, n0[Z] + part->mt[Z] + 1};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    Real *data = NULL; /* probed data of all partitions */
     RealVec p1 = {0.0};
     RealVec p2 = {0.0};
     RealVec dl = {0.0};
     int stepN = 0;
     int i = 0, j = 0, k = 0;
     for (int n = 0; n < time->dataN[PROLN]; ++n) {
-        snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "line_probe_", n + 1, time->stepC);
-        fp = Fopen(fname, "w");
-        fprintf(fp, "# x, y, z, rho, u, v, w, p, T <time=%.6g>\n", time->now);
         p1[X] = time->lp[n][0];
         p1[Y] = time->lp[n][1];
         p1[Z] = time->lp[n][2];
@@ -95,24 +101,52 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
         dl[X] = (p2[X] - p1[X]) / (Real)(stepN);
         dl[Y] = (p2[Y] - p1[Y]) / (Real)(stepN);
         dl[Z] = (p2[Z] - p1[Z]) / (Real)(stepN);
-        idxOld = -1; /* used to avoid repeating node for tiny step sizes */
+        /* each probed node is filled by its owning partition and merged by summation */
+        data = AssignStorage((stepN + 1) * DIMUo * sizeof(*data), MEMPROBE);
         for (int m = 0; m <= stepN; ++m) {
-            i = ConfineSpace(MapNode(p1[X] + m * dl[X], sMin[X], dd[X], ng[X]), nMin[X], nMax[X]);
-            j = ConfineSpace(MapNode(p1[Y] + m * dl[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
-            k = ConfineSpace(MapNode(p1[Z] + m * dl[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
+            i = ConfineSpace(MapNode(p1[X] + m * dl[X], sMin[X], dd[X], n0[X]), nMin[X], nMax[X]);
+            j = ConfineSpace(MapNode(p1[Y] + m * dl[Y], sMin[Y], dd[Y], n0[Y]), nMin[Y], nMax[Y]);
+            k = ConfineSpace(MapNode(p1[Z] + m * dl[Z], sMin[Z], dd[Z], n0[Z]), nMin[Z], nMax[Z]);
+            for (int dim = 0; dim < DIMUo; ++dim) {
+                data[m * DIMUo + dim] = 0.0;
+            }
+            if (!InPartBox(k, j, i, part->ns[PHY])) {
+                continue;
+            }
             idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+            GatherU(idx, field->U[TO], U);
+            MapPrimitive(model->gamma, model->gasR, U, Uo);
+            for (int dim = 0; dim < DIMUo; ++dim) {
+                data[m * DIMUo + dim] = Uo[dim];
+            }
+        }
+        ReduceSum((stepN + 1) * DIMUo, data, part);
+        if (0 != part->rank) { /* only the root process writes shared files */
+            RetrieveStorage(data);
+            continue;
+        }
+        snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "line_probe_", n + 1, time->stepC);
+        fp = Fopen(fname, "w");
+        fprintf(fp, "# x, y, z, rho, u, v, w, p, T <time=%.6g>\n", time->now);
+        idxOld = -1; /* used to avoid repeating node for tiny step sizes */
+        for (int m = 0; m <= stepN; ++m) {
+            i = ConfineSpace(MapNode(p1[X] + m * dl[X], sMin[X], dd[X], n0[X]), nMin[X], nMax[X]);
+            j = ConfineSpace(MapNode(p1[Y] + m * dl[Y], sMin[Y], dd[Y], n0[Y]), nMin[Y], nMax[Y]);
+            k = ConfineSpace(MapNode(p1[Z] + m * dl[Z], sMin[Z], dd[Z], n0[Z]), nMin[Z], nMax[Z]);
+            idx = IndexNode(k - n0[Z], j - n0[Y], i - n0[X], part->mt[Y] + 1, part->mt[X] + 1);
             if (idxOld == idx) {
                 continue;
             }
             idxOld = idx; /* record */
-            p2[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-            p2[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-            p2[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-            MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+            p2[X] = MapPoint(i, sMin[X], d[X], n0[X]);
+            p2[Y] = MapPoint(j, sMin[Y], d[Y], n0[Y]);
+            p2[Z] = MapPoint(k, sMin[Z], d[Z], n0[Z]);
+            const Real *const Ud = data + m * DIMUo;
             fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                    p2[X], p2[Y], p2[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
+                    p2[X], p2[Y], p2[Z], Ud[0], Ud[1], Ud[2], Ud[3], Ud[4], Ud[5]);
         }
         fclose(fp);
+        RetrieveStorage(data);
     }
     return;
 }
@@ -124,56 +158,43 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
     FILE *fp = NULL;
     String fname = {'\0'};
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
+    const Interface *const ibm = &(field->ibm);
     const Geometry *const geo = &(space->geo);
-    const Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
+    const Ghost *ghost = NULL;
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
-    const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    RealVec pG = {0.0}; /* ghost point */
-    RealVec pO = {0.0}; /* boundary point */
-    RealVec pI = {0.0}; /* image point */
-    RealVec N = {0.0}; /* normal */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
         snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
-        fp = Fopen(fname, "w");
-        fprintf(fp, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now);
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+        /* partitions append their own probes in the order of process rank */
+        for (int r = 0; r < part->rank; ++r) {
+            SynchronizeProcess(part);
         }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].gst) || (n + 1 != node[idx].did)) {
-                        continue;
-                    }
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                            pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
-                }
-            }
+        if (0 == part->rank) {
+            fp = Fopen(fname, "w");
+            fprintf(fp, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now);
+        } else {
+            fp = Fopen(fname, "a");
+        }
+        /* ghost nodes of the first layer of the polyhedron */
+        for (int m = ibm->ghead[n]; m < ibm->ghead[n+1]; ++m) {
+            ghost = ibm->ghost + m;
+            GatherU(ghost->idx, field->U[TO], U);
+            MapPrimitive(model->gamma, model->gasR, U, Uo);
+            fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
+                    ghost->pO[X], ghost->pO[Y], ghost->pO[Z], ghost->N[X], ghost->N[Y], ghost->N[Z],
+                    Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         }
         fclose(fp);
+        for (int r = part->rank; r < part->rankN; ++r) {
+            SynchronizeProcess(part);
+        }
     }
     return;
 }
 void WriteSurfaceForceData(const Time *time, const Space *space, const Model *model)
 {
-    if (0 == time->dataN[PROFC]) {
+    if ((0 == time->dataN[PROFC]) || (0 != space->part.rank)) {
         return;
     }
     FILE *fp = NULL;
@@ -81,6 +81,9 @@ void ReadData(const int n, Time *time, Space *space, const Model *model)
 static void WriteSpaceData(const Time *time, const Space *space, const Model *model)
 {
     WriteFieldData(time, space, model);
+    if (0 != space->part.rank) { /* geometry and state data are shared by all processes */
+        return;
+    }
     WriteGeometryData(time, &(space->geo));
     WriteStateData(time);
     return;
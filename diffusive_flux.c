@@ -19,19 +19,19 @@
  * Function Pointers
  ****************************************************************************/
 typedef void (*FvhatReconstructor)(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void ComputeFvhatX(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 static void ComputeFvhatY(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 static void ComputeFvhatZ(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
@@ -44,7 +44,7 @@ static FvhatReconstructor ReconstructFvhat[DIMS] = {
  * Function definitions
  ****************************************************************************/
 void ComputeFvhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int stride[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
     const Real zero = 0.0;
@@ -52,66 +52,68 @@ void ComputeFvhat(const int tn, const int s, const int k, const int j, const int
         memset(Fvhat, 0, DIMU * sizeof(*Fvhat));
         return;
     }
-    ReconstructFvhat[s](tn, k, j, i, partn, dd, node, model, Fvhat);
+    ReconstructFvhat[s](tn, k, j, i, stride, dd, field, model, Fvhat);
     return;
 }
 static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int stride[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxSE = IndexNode(k, j - 1, i + 1, partn[Y], partn[X]);
-    const int idxNE = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFE = IndexNode(k - 1, j, i + 1, partn[Y], partn[X]);
-    const int idxBE = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idx = IndexStride(k, j, i, stride);
+    const int idxS = IndexStride(k, j - 1, i, stride);
+    const int idxN = IndexStride(k, j + 1, i, stride);
+    const int idxF = IndexStride(k - 1, j, i, stride);
+    const int idxB = IndexStride(k + 1, j, i, stride);
+
+    const int idxE = IndexStride(k, j, i + 1, stride);
+    const int idxSE = IndexStride(k, j - 1, i + 1, stride);
+    const int idxNE = IndexStride(k, j + 1, i + 1, stride);
+    const int idxFE = IndexStride(k - 1, j, i + 1, stride);
+    const int idxBE = IndexStride(k + 1, j, i + 1, stride);
+
+    FdReal *const *const Uf = field->U[tn];
+    Real U[DIMU] = {0.0};
+    GatherU(idx, Uf, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxS].U[tn];
+    GatherU(idxS, Uf, U);
     const Real uS = U[1] / U[0];
     const Real vS = U[2] / U[0];
 
-    U = node[idxN].U[tn];
+    GatherU(idxN, Uf, U);
     const Real uN = U[1] / U[0];
     const Real vN = U[2] / U[0];
 
-    U = node[idxF].U[tn];
+    GatherU(idxF, Uf, U);
     const Real uF = U[1] / U[0];
     const Real wF = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    GatherU(idxB, Uf, U);
     const Real uB = U[1] / U[0];
     const Real wB = U[3] / U[0];
 
-    U = node[idxE].U[tn];
+    GatherU(idxE, Uf, U);
     const Real uE = U[1] / U[0];
     const Real vE = U[2] / U[0];
     const Real wE = U[3] / U[0];
     const Real TE = ComputeTemperature(model->cv, U);
 
-    U = node[idxSE].U[tn];
+    GatherU(idxSE, Uf, U);
     const Real uSE = U[1] / U[0];
     const Real vSE = U[2] / U[0];
 
-    U = node[idxNE].U[tn];
+    GatherU(idxNE, Uf, U);
     const Real uNE = U[1] / U[0];
     const Real vNE = U[2] / U[0];
 
-    U = node[idxFE].U[tn];
+    GatherU(idxFE, Uf, U);
     const Real uFE = U[1] / U[0];
     const Real wFE = U[3] / U[0];
 
-    U = node[idxBE].U[tn];
+    GatherU(idxBE, Uf, U);
     const Real uBE = U[1] / U[0];
     const Real wBE = U[3] / U[0];
 
@@ -141,62 +143,64 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
     return;
 }
 static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int stride[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxWN = IndexNode(k, j + 1, i - 1, partn[Y], partn[X]);
-    const int idxEN = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFN = IndexNode(k - 1, j + 1, i, partn[Y], partn[X]);
-    const int idxBN = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idx = IndexStride(k, j, i, stride);
+    const int idxW = IndexStride(k, j, i - 1, stride);
+    const int idxE = IndexStride(k, j, i + 1, stride);
+    const int idxF = IndexStride(k - 1, j, i, stride);
+    const int idxB = IndexStride(k + 1, j, i, stride);
+
+    const int idxN = IndexStride(k, j + 1, i, stride);
+    const int idxWN = IndexStride(k, j + 1, i - 1, stride);
+    const int idxEN = IndexStride(k, j + 1, i + 1, stride);
+    const int idxFN = IndexStride(k - 1, j + 1, i, stride);
+    const int idxBN = IndexStride(k + 1, j + 1, i, stride);
+
+    FdReal *const *const Uf = field->U[tn];
+    Real U[DIMU] = {0.0};
+    GatherU(idx, Uf, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxW].U[tn];
+    GatherU(idxW, Uf, U);
     const Real uW = U[1] / U[0];
     const Real vW = U[2] / U[0];
 
-    U = node[idxE].U[tn];
+    GatherU(idxE, Uf, U);
     const Real uE = U[1] / U[0];
     const Real vE = U[2] / U[0];
 
-    U = node[idxF].U[tn];
+    GatherU(idxF, Uf, U);
     const Real vF = U[2] / U[0];
     const Real wF = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    GatherU(idxB, Uf, U);
     const Real vB = U[2] / U[0];
     const Real wB = U[3] / U[0];
 
-    U = node[idxN].U[tn];
+    GatherU(idxN, Uf, U);
     const Real uN = U[1] / U[0];
     const Real vN = U[2] / U[0];
     const Real wN = U[3] / U[0];
     const Real TN = ComputeTemperature(model->cv, U);
 
-    U = node[idxWN].U[tn];
+    GatherU(idxWN, Uf, U);
     const Real uWN = U[1] / U[0];
     const Real vWN = U[2] / U[0];
 
-    U = node[idxEN].U[tn];
+    GatherU(idxEN, Uf, U);
     const Real uEN = U[1] / U[0];
     const Real vEN = U[2] / U[0];
 
-    U = node[idxFN].U[tn];
+    GatherU(idxFN, Uf, U);
     const Real vFN = U[2] / U[0];
     const Real wFN = U[3] / U[0];
 
-    U = node[idxBN].U[tn];
+    GatherU(idxBN, Uf, U);
     const Real vBN = U[2] / U[0];
     const Real wBN = U[3] / U[0];
 
@@ -226,62 +230,64 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
     return ;
 }
 static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int stride[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-    const int idxWB = IndexNode(k + 1, j, i - 1, partn[Y], partn[X]);
-    const int idxEB = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
-    const int idxSB = IndexNode(k + 1, j - 1, i, partn[Y], partn[X]);
-    const int idxNB = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idx = IndexStride(k, j, i, stride);
+    const int idxW = IndexStride(k, j, i - 1, stride);
+    const int idxE = IndexStride(k, j, i + 1, stride);
+    const int idxS = IndexStride(k, j - 1, i, stride);
+    const int idxN = IndexStride(k, j + 1, i, stride);
+
+    const int idxB = IndexStride(k + 1, j, i, stride);
+    const int idxWB = IndexStride(k + 1, j, i - 1, stride);
+    const int idxEB = IndexStride(k + 1, j, i + 1, stride);
+    const int idxSB = IndexStride(k + 1, j - 1, i, stride);
+    const int idxNB = IndexStride(k + 1, j + 1, i, stride);
+
+    FdReal *const *const Uf = field->U[tn];
+    Real U[DIMU] = {0.0};
+    GatherU(idx, Uf, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxW].U[tn];
+    GatherU(idxW, Uf, U);
     const Real uW = U[1] / U[0];
     const Real wW = U[3] / U[0];
 
-    U = node[idxE].U[tn];
+    GatherU(idxE, Uf, U);
     const Real uE = U[1] / U[0];
     const Real wE = U[3] / U[0];
 
-    U = node[idxS].U[tn];
+    GatherU(idxS, Uf, U);
     const Real vS = U[2] / U[0];
     const Real wS = U[3] / U[0];
 
-    U = node[idxN].U[tn];
+    GatherU(idxN, Uf, U);
     const Real vN = U[2] / U[0];
     const Real wN = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    GatherU(idxB, Uf, U);
     const Real uB = U[1] / U[0];
     const Real vB = U[2] / U[0];
     const Real wB = U[3] / U[0];
     const Real TB = ComputeTemperature(model->cv, U);
 
-    U = node[idxWB].U[tn];
+    GatherU(idxWB, Uf, U);
     const Real uWB = U[1] / U[0];
     const Real wWB = U[3] / U[0];
 
-    U = node[idxEB].U[tn];
+    GatherU(idxEB, Uf, U);
     const Real uEB = U[1] / U[0];
     const Real wEB = U[3] / U[0];
 
-    U = node[idxSB].U[tn];
+    GatherU(idxSB, Uf, U);
     const Real vSB = U[2] / U[0];
     const Real wSB = U[3] / U[0];
 
-    U = node[idxNB].U[tn];
+    GatherU(idxNB, Uf, U);
     const Real vNB = U[2] / U[0];
     const Real wNB = U[3] / U[0];
 
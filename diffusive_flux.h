@@ -27,11 +27,12 @@
  * Diffusive flux
  *
  * Function
- *      Reconstruct the numerical diffusive flux.
+ *      Reconstruct the numerical diffusive flux. Nodes are located in
+ *      the field arrays by the strides of the node space (see IndexStride).
  */
 extern void ComputeFvhat(const int tn, const int s, const int k, const int j,
-        const int i, const int partn[restrict], const Real dd[restrict],
-        const Node *const, const Model *, Real Fvhat[restrict]);
+        const int i, const int stride[restrict], const Real dd[restrict],
+        const Field *const, const Model *, Real Fvhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
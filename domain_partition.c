@@ -12,13 +12,19 @@
  * Required Header Files
  ****************************************************************************/
 #include "domain_partition.h"
+#include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void DecomposeDomain(Partition *const);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void PartitionDomain(Space *space)
 {
     Partition *const part = &(space->part);
+    DecomposeDomain(part);
     /*
      * Outward facing surface unit normal vector of domain boundary
      * Surface normal vector can provide great advantage: every surface can
@@ -70,6 +76,32 @@ void PartitionDomain(Space *space)
             part->ns[PIN][s][MIN] = part->ng[s] + 1;
             part->ns[PIN][s][MAX] = part->n[s] - part->ng[s] - 1;
         }
+        /* a boundary shared with a neighbouring partition is computed as interior */
+        if (NONE != part->nbr[q]) {
+            part->ns[PIN][s][MIN] = part->ng[s];
+        }
+        if (NONE != part->nbr[q+1]) {
+            part->ns[PIN][s][MAX] = part->n[s] - part->ng[s];
+        }
+        /* extended region covers the halos of neighbouring partitions */
+        part->ns[PEX][s][MIN] = part->ns[PIN][s][MIN];
+        part->ns[PEX][s][MAX] = part->ns[PIN][s][MAX];
+        if (NONE != part->nbr[q]) {
+            part->ns[PEX][s][MIN] = 0;
+        }
+        if (NONE != part->nbr[q+1]) {
+            part->ns[PEX][s][MAX] = part->n[s];
+        }
+        /*
+         * iostream region overlaps the upper neighbour by one node layer to
+         * join data pieces. A periodic neighbour of the last block is not
+         * joined, and in omp mode proc is the thread grid without neighbours.
+         */
+        part->ns[PIO][s][MIN] = part->ns[PIN][s][MIN];
+        part->ns[PIO][s][MAX] = part->ns[PIN][s][MAX];
+        if ((NONE != part->nbr[q+1]) && (part->proc[s] - 1 > part->pid[s])) {
+            part->ns[PIO][s][MAX] = part->ns[PIO][s][MAX] + 1;
+        }
         /* boundary box */
         for (int p = PWB; p <= PBB; ++p) {
             part->ns[p][s][MIN] = part->ng[s];
@@ -148,5 +180,65 @@ void PartitionDomain(Space *space)
     part->pathSep[0] = part->pathSep[part->gl];
     return;
 }
+/*
+ * Block decomposition for message passing
+ * The m + 1 node layers of the entire domain on each dimension are
+ * distributed as evenly as possible among the processors of that
+ * dimension, and each process only stores its own block of node layers
+ * plus the halo layers. A block boundary shared with a neighbouring block
+ * requires ng = gl halo layers, which are filled by message passing
+ * rather than by boundary conditions. When a periodic dimension is
+ * decomposed, the first and the last blocks become neighbours. Node
+ * mapping is kept with respect to the entire domain to ensure the
+ * coordinates of each node are identical to a nondecomposed run.
+ */
+static void DecomposeDomain(Partition *const part)
+{
+    int rank = part->rank;
+    for (int s = 0; s < DIMS; ++s) {
+        part->pid[s] = 0;
+    }
+    for (int p = 0; p < NBC; ++p) {
+        part->nbr[p] = NONE;
+    }
+    if (1 == part->rankN) {
+        return;
+    }
+    /* coordinates of current process in the processor grid */
+    for (int s = 0; s < DIMS; ++s) {
+        part->pid[s] = rank % part->proc[s];
+        rank = rank / part->proc[s];
+    }
+    for (int s = 0, p = PWB; s < DIMS; ++s, p = p + 2) {
+        if (1 == part->proc[s]) {
+            continue;
+        }
+        /* node layers owned by current process */
+        const int totN = part->mt[s] + 1;
+        const int base = totN / part->proc[s];
+        const int rem = totN % part->proc[s];
+        const int offset = part->pid[s] * base + MinInt(part->pid[s], rem);
+        const int ownN = base + (rem > part->pid[s]);
+        if (part->gl + 1 > ownN) {
+            ShowError("too many processors for the mesh on dimension %d", s);
+        }
+        /* neighbouring processes */
+        IntVec pid = {part->pid[X], part->pid[Y], part->pid[Z]};
+        if ((0 < part->pid[s]) || (PERIODIC == part->typeBC[p])) {
+            pid[s] = (part->pid[s] + part->proc[s] - 1) % part->proc[s];
+            part->nbr[p] = (pid[Z] * part->proc[Y] + pid[Y]) * part->proc[X] + pid[X];
+        }
+        if ((part->proc[s] - 1 > part->pid[s]) || (PERIODIC == part->typeBC[p+1])) {
+            pid[s] = (part->pid[s] + 1) % part->proc[s];
+            part->nbr[p+1] = (pid[Z] * part->proc[Y] + pid[Y]) * part->proc[X] + pid[X];
+        }
+        /* local block with halos */
+        part->ng[s] = part->gl;
+        part->m[s] = ownN - 1;
+        part->n[s] = part->m[s] + 1 + 2 * part->ng[s];
+        part->n0[s] = part->ng[s] - offset;
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
@@ -47,6 +47,9 @@ void ReadStructuredDataEnsight(Time *time, Space *space, const Model *model)
         .vecN = 0,
         .vec = {{'\0'}},
     };
+    if (1 < space->part.rankN) { /* each partition reads its own case */
+        snprintf(enSet.rname, sizeof(EnStr), "p%d_field", space->part.rank);
+    }
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
     ReadCaseFile(time, &enSet);
     ReadStructuredData(space, model, &enSet);
@@ -67,9 +70,14 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
     FILE *fp = NULL;
     EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL;
+    Field *const field = &(space->field);
+    FdReal *const *const U = field->U[TO];
     int idx = 0; /* linear array index math variable */
+    for (int tn = 0; tn < model->levelN; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            memset(field->U[tn][n], 1, field->stride * sizeof(*field->U[tn][n]));
+        }
+    }
     for (int s = 0; s < enSet->scaN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
         fp = Fopen(enSet->fname, "rb");
@@ -84,39 +92,38 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                         if (0 == s) {
                             /* geometric field initializer */
-                            node[idx].did = NONE;
-                            node[idx].fid = NONE;
-                            node[idx].lid = NONE;
-                            node[idx].gst = NONE;
-                            memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                            field->did[idx] = NONE;
+                            field->fid[idx] = NONE;
+                            field->lid[idx] = NONE;
+                            field->gst[idx] = NONE;
                             if (InPartBox(k, j, i, part->ns[PIN])) {
-                                node[idx].did = 0;
-                                node[idx].fid = 0;
-                                node[idx].lid = 0;
-                                node[idx].gst = 0;
+                                field->did[idx] = 0;
+                                field->fid[idx] = 0;
+                                field->lid[idx] = 0;
+                                field->gst[idx] = 0;
                             }
                         }
                         if (!InPartBox(k, j, i, part->ns[p])) {
                             continue;
                         }
                         /* data field initializer */
-                        U = node[idx].U[TO];
                         Fread(&data, sizeof(EnReal), 1, fp);
                         switch (s) {
                             case 0: /* rho */
-                                U[0] = data;
+                                U[0][idx] = data;
                                 break;
                             case 1: /* u */
-                                U[1] = U[0] * data;
+                                U[1][idx] = U[0][idx] * data;
                                 break;
                             case 2: /* v */
-                                U[2] = U[0] * data;
+                                U[2][idx] = U[0][idx] * data;
                                 break;
                             case 3: /* w */
-                                U[3] = U[0] * data;
+                                U[3][idx] = U[0][idx] * data;
                                 break;
                             case 4: /* p */
-                                U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] +
+                                U[4][idx] = 0.5 * (U[1][idx] * U[1][idx] + U[2][idx] * U[2][idx] +
+                                    U[3][idx] * U[3][idx]) / U[0][idx] +
                                     data / (model->gamma - 1.0);
                                 break;
                             default:
@@ -203,7 +210,7 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Fread(enSet->str, sizeof(EnStr), 1, fp);
         Fread(&ne, sizeof(int), 1, fp);
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
+        poly->mesh = p; /* meshes are restored in the current frame */
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
                 Fread(&data, sizeof(EnReal), 1, fp);
@@ -217,11 +224,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
                 Fread(&m, sizeof(int), 1, fp);
                 poly->f[n][s] = m - 1;
             }
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdge(poly);
     }
     ReadPolyState(pm, pn, geo, enSet);
     return;
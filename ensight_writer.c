@@ -15,12 +15,14 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
+#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void InitializeTransientCaseFile(EnSet *);
+static void WriteServerFile(const Partition *const);
 static void WriteCaseFile(const Time *, EnSet *);
 static void WriteGeometryFile(const Space *, EnSet *);
 static void WriteStructuredData(const Space *, const Model *, EnSet *);
@@ -50,10 +52,16 @@ void WriteStructuredDataEnsight(const Time *time, const Space *space, const Mode
         .vecN = 1,
         .vec = {"Vel"},
     };
+    if (1 < space->part.rankN) { /* each partition writes its own case */
+        snprintf(enSet.rname, sizeof(EnStr), "p%d_field", space->part.rank);
+    }
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
     if (0 == time->stepC) { /* initialization step */
         InitializeTransientCaseFile(&enSet);
         WriteGeometryFile(space, &enSet);
+        if ((1 < space->part.rankN) && (0 == space->part.rank)) {
+            WriteServerFile(&(space->part));
+        }
     }
     WriteCaseFile(time, &enSet);
     WriteStructuredData(space, model, &enSet);
@@ -88,6 +96,28 @@ static void InitializeTransientCaseFile(EnSet *enSet)
     fclose(fp);
     return;
 }
+/*
+ * The server of server file joins the transient case of each partition
+ * into the entire domain.
+ */
+static void WriteServerFile(const Partition *const part)
+{
+    FILE *fp = Fopen("field.sos", "w");
+    fprintf(fp, "FORMAT\n");
+    fprintf(fp, "type: master_server gold\n");
+    fprintf(fp, "\n");
+    fprintf(fp, "SERVERS\n");
+    fprintf(fp, "number of servers: %d\n", part->rankN);
+    for (int r = 0; r < part->rankN; ++r) {
+        fprintf(fp, "\n");
+        fprintf(fp, "#Server %d\n", r + 1);
+        fprintf(fp, "machine id: localhost\n");
+        fprintf(fp, "executable: ensight_server\n");
+        fprintf(fp, "casefile: p%d_field.case\n", r);
+    }
+    fclose(fp);
+    return;
+}
 static void WriteCaseFile(const Time *time, EnSet *enSet)
 {
     snprintf(enSet->fname, sizeof(EnStr), "%s.case", enSet->bname);
@@ -157,7 +187,7 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
         strncpy(enSet->str, "part", sizeof(EnStr));
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
         fwrite(&pnum, sizeof(int), 1, fp);
-        snprintf(enSet->str, sizeof(EnStr), "part %d", p);
+        snprintf(enSet->str, sizeof(EnStr), "part %d", pnum - 1);
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
         strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
@@ -170,7 +200,7 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
                 for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
                     for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
                         ne[X] = i; ne[Y] = j; ne[Z] = k;
-                        data = MapPoint(ne[s], part->domain[s][MIN], part->d[s], part->ng[s]);
+                        data = MapPoint(ne[s], part->domain[s][MIN], part->d[s], part->n0[s]);
                         fwrite(&data, sizeof(EnReal), 1, fp);
                     }
                 }
@@ -190,8 +220,8 @@ static void WriteStructuredData(const Space *space, const Model *model, EnSet *e
     FILE *fp = NULL;
     EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
-    const Real *restrict U = NULL;
+    const Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
     for (int s = 0; s < enSet->scaN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
@@ -211,7 +241,7 @@ static void WriteStructuredData(const Space *space, const Model *model, EnSet *e
                 for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
                     for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
                         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
+                        GatherU(idx, field->U[TO], U);
                         switch (s) {
                             case 0: /* rho */
                                 data = U[0];
@@ -232,7 +262,7 @@ static void WriteStructuredData(const Space *space, const Model *model, EnSet *e
                                 data = ComputeTemperature(model->cv, U);
                                 break;
                             case 6: /* node flag */
-                                data = node[idx].did;
+                                data = field->did[idx];
                                 break;
                             default:
                                 break;
@@ -261,7 +291,7 @@ static void WriteStructuredData(const Space *space, const Model *model, EnSet *e
                     for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
                         for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
                             idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                            U = node[idx].U[TO];
+                            GatherU(idx, field->U[TO], U);
                             data = U[n] / U[0];
                             fwrite(&data, sizeof(EnReal), 1, fp);
                         }
@@ -386,6 +416,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     FILE *fp = Fopen(enSet->fname, "wb");
     EnReal data = 0.0; /* the Ensight data format */
     const Polyhedron *poly = NULL;
+    RealVec pv = {0.0}; /* vertex in the current frame */
     int ne = 0; /* total number of nodes in a part */
     /* description at the beginning */
     strncpy(enSet->str, "C Binary", sizeof(EnStr));
@@ -413,7 +444,8 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fwrite(&ne, sizeof(int), 1, fp);
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
-                data = poly->v[n][s];
+                BodyToCurrent(poly->v[n], poly, pv);
+                data = pv[s];
                 fwrite(&data, sizeof(EnReal), 1, fp);
             }
         }
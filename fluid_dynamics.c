@@ -13,34 +13,55 @@
  ****************************************************************************/
 #include "fluid_dynamics.h"
 #include "convective_flux.h"
+#include "weno.h"
 #include "diffusive_flux.h"
 #include "source_term.h"
 #include "boundary_treatment.h"
+#include "timer.h"
+#include "roofline.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
 typedef void (*TimeIntegrator)(const Real, const int, Space *, const Model *);
+typedef void (*SpatialOperator)(const Real, const Real, const Real, const int,
+        const int, const int, const int, Space *, const Model *);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void DiscretizeTime(const Real, const int, Space *, const Model *);
 static void RungeKutta2(const Real, const int, Space *, const Model *);
 static void RungeKutta3(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta2(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta3(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta(const int, const Real [restrict], const Real [restrict],
+        const Real, const int, Space *, const Model *);
+static void UpdateStage(const Real, const int, const int, Space *);
 static void LLLU(const Real, const Real, const Real, const int,
         const int, const int, const int, Space *, const Model *);
+static void NodeLLLU(const Real, const Real, const Real, const int,
+        const int, const int, const int, Space *, const Model *);
+static void PencilLLLU(const Real, const Real, const Real, const int,
+        const int, const int, const int, Space *, const Model *);
+static void GatherTile(FdReal *const [restrict], int [restrict][LIMIT], const int [restrict],
+        const int [restrict], FdReal *const [restrict]);
 static void LU(const Real [restrict], const Real [restrict],
         const Real [restrict], const Real [restrict], Real [restrict]);
-static void SolveOperator(const int, const int, const Real, const Real,
-        const Real [restrict], const Real [restrict], Real [restrict], const Real,
+static void SolveOperator(const int, const int, const Real, const Real, const int,
+        FdReal *const [restrict], FdReal *const [restrict], FdReal *const [restrict], const Real,
         const Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static TimeIntegrator IntegrateTime[2] = {
+static TimeIntegrator IntegrateTime[4] = {
     RungeKutta2,
-    RungeKutta3};
+    RungeKutta3,
+    LowStorageRungeKutta2,
+    LowStorageRungeKutta3};
+static SpatialOperator ComputeLLLU[2] = {
+    NodeLLLU,
+    PencilLLLU};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -146,6 +167,65 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
     TreatBoundary(TO, space, model);
     return;
 }
+/*
+ * Low-storage Runge-Kutta schemes of Williamson type only store the solution
+ * U in TO and the stage increment dU in TN, for each stage m
+ *   dU = A[m] * dU + dt * LU; U = U + B[m] * dU.
+ * The second order scheme is the SSP (Heun) scheme in 2N form. The third
+ * order scheme is the 2N form SSP scheme of Gottlieb and Shu (1998), which
+ * is TVD with a CFL coefficient of 0.32 rather than 1 of the classic SSP
+ * scheme; its stability region is that of any three stage third order
+ * scheme. The coefficients are the published ones, exact to about 1e-11.
+ */
+static void LowStorageRungeKutta2(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real A[2] = {0.0, -1.0};
+    const Real B[2] = {1.0, 1.0/2.0};
+    LowStorageRungeKutta(2, A, B, dt, s, space, model);
+    return;
+}
+static void LowStorageRungeKutta3(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real A[3] = {0.0, -2.915492524638791, -0.000000093517376};
+    const Real B[3] = {0.924574000000000, 0.287713063186749, 0.626538109512740};
+    LowStorageRungeKutta(3, A, B, dt, s, space, model);
+    return;
+}
+static void LowStorageRungeKutta(const int stageN, const Real A[restrict], const Real B[restrict],
+        const Real dt, const int s, Space *space, const Model *model)
+{
+    for (int m = 0; m < stageN; ++m) {
+        /* solve dU = A * dU + dt * LUn, the time level to is NONE for the increment form */
+        LLLU(dt, A[m], 1.0, NONE, TO, TN, s, space, model);
+        /* solve U = U + B * dU */
+        UpdateStage(B[m], TO, TN, space);
+        TreatBoundary(TO, space, model);
+    }
+    return;
+}
+/*
+ * Add the stage increment in tn to the solution in to at fluid nodes.
+ */
+static void UpdateStage(const Real coe, const int to, const int tn, Space *space)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    FdReal *const *const Uo = field->U[to];
+    FdReal *const *const Un = field->U[tn];
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            const int idx = IndexNode(k, j, 0, part->n[Y], part->n[X]);
+            for (int n = 0; n < DIMU; ++n) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    const Real U = Uo[n][idx+i] + coe * Un[n][idx+i];
+                    Uo[n][idx+i] = (0 == field->did[idx+i]) ? U : Uo[n][idx+i];
+                }
+            }
+        }
+    }
+    return;
+}
 /*
  * Spatial operator computation.
  * LLLU = coeA * Un + coeB * LLU; LLU = (I + dt*L)U; L = {Ls, phi}; s = X, Y, Z.
@@ -153,87 +233,302 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
  * algorithms and function pointers to unify the function and code for each
  * value of p. If a function is too difficult to do general coding, then code
  * functions for each operator individually.
+ * The source term has no numerical flux, hence it is always solved node by node.
  */
 static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
         const int tn, const int tm, const int p, Space *space, const Model *model)
+{
+    if (PHI == p) {
+        NodeLLLU(dt, coeA, coeB, to, tn, tm, p, space, model);
+        return;
+    }
+    ComputeLLLU[model->fluxKernel](dt, coeA, coeB, to, tn, tm, p, space, model);
+    return;
+}
+/*
+ * Node kernel: nodes of a pencil are solved in sequence, and the numerical
+ * flux at the right interface of a node is inherited by the next node as
+ * its left interface flux.
+ */
+static void NodeLLLU(const Real dt, const Real coeA, const Real coeB, const int to,
+        const int tn, const int tm, const int p, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
-    int i = 0, j = 0, k = 0; /* index with normal order */
+    const Field *const field = &(space->field);
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    Real RHS[5][DIMU] = {{0.0}}; /* spatial operator */
-    Real *restrict FhatR = RHS[0]; /* reconstructed numerical convective flux vector */
-    Real *restrict FhatL = RHS[1]; /* reconstructed numerical convective flux vector */
-    Real *restrict FvhatR = RHS[2]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict FvhatL = RHS[3]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict Phi = RHS[4]; /* right hand side vector */
-    Real *temp = NULL;
     const IntVec partn = {part->n[X], part->n[Y], part->n[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
-    int s = 0, sN = 0; /* space sweep control for the operator p */
+    FdReal *const *const Uo = (NONE == to) ? NULL : field->U[to]; /* NULL for the increment form */
+    const int stride[DIMS+1] = {1, partn[X], partn[X] * partn[Y], 0}; /* strides of the field */
+    int sM = 0, sN = 0; /* space sweep control for the operator p */
     switch (p) {
         case PHI: /* source term */
-            s = 0; sN = s + 1;
+            sM = 0; sN = sM + 1;
             break;
         case DIMS: /* all spatial operators */
-            s = 0; sN = DIMS;
+            sM = 0; sN = DIMS;
             break;
         default: /* individual spatial operator */
-            s = p; sN = s + 1;
+            sM = p; sN = sM + 1;
             break;
     }
-    /* space sweep with dimension priority */
-    for (; s < sN; ++s) {
-        for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
-            for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
-                for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
-                    switch (s) {
-                        case X:
-                            i = is; j = js; k = ks;
-                            break;
-                        case Y:
-                            i = js; j = is; k = ks;
-                            break;
-                        case Z:
-                            i = js; j = ks; k = is;
-                            break;
-                        default:
-                            break;
-                    }
-                    idx = IndexNode(k, j, i, partn[Y], partn[X]);
-                    if (0 != node[idx].did) {
-                        state = 0; /* mark domain change and boundary occurrence */
-                        continue;
+    /*
+     * Pencils along the sweep direction are independent of each other since
+     * the operator only reads time level tn and writes time level tm at the
+     * node being solved. Therefore, pencils are distributed among threads and
+     * each thread owns its scratch space for the spatial operator. Only the
+     * fluid spans of a pencil are solved.
+     */
+    #pragma omp parallel
+    {
+        int idx = 0; /* linear array index math variable */
+        int i = 0, j = 0, k = 0; /* index with normal order */
+        Real RHS[5][DIMU] = {{0.0}}; /* spatial operator */
+        Real *restrict FhatR = RHS[0]; /* reconstructed numerical convective flux vector */
+        Real *restrict FhatL = RHS[1]; /* reconstructed numerical convective flux vector */
+        Real *restrict FvhatR = RHS[2]; /* reconstructed numerical diffusive flux vector */
+        Real *restrict FvhatL = RHS[3]; /* reconstructed numerical diffusive flux vector */
+        Real *restrict Phi = RHS[4]; /* right hand side vector */
+        Real *temp = NULL;
+        /* space sweep with dimension priority */
+        for (int s = sM; s < sN; ++s) {
+            #pragma omp master
+            if (PHI != p) {
+                StartRegion(RGSWEEP + s);
+                StartKernel(RFSWEEP + s);
+            }
+            const Run *const run = field->run + s;
+            const int jM = part->np[s][Y][MIN];
+            const int jN = part->np[s][Y][MAX];
+            const int kM = part->np[s][Z][MIN];
+            #pragma omp for collapse(2) schedule(static)
+            for (int ks = kM; ks < part->np[s][Z][MAX]; ++ks) {
+                for (int js = jM; js < jN; ++js) {
+                    const int pen = (ks - kM) * (jN - jM) + (js - jM);
+                    for (int q = run->head[pen]; q < run->head[pen+1]; ++q) {
+                        /* the flux at the left interface of a span is not inherited */
+                        for (int is = run->span[q][MIN], state = 0; is < run->span[q][MAX]; ++is) {
+                            switch (s) {
+                                case X:
+                                    i = is; j = js; k = ks;
+                                    break;
+                                case Y:
+                                    i = js; j = is; k = ks;
+                                    break;
+                                case Z:
+                                    i = js; j = ks; k = is;
+                                    break;
+                                default:
+                                    break;
+                            }
+                            idx = IndexNode(k, j, i, partn[Y], partn[X]);
+                            switch (p) {
+                                case PHI:
+                                    ComputePhi(tn, k, j, i, partn, field, model, Phi);
+                                    SolveOperator(OPTSPLIT, s, coeA, coeB, idx, Uo, field->U[tn], field->U[tm], dt, Phi);
+                                    continue;
+                                default:
+                                    break;
+                            }
+                            switch (state) {
+                                case 1: /* inherit numerical flux from the previous node */
+                                    temp = FhatL;
+                                    FhatL = FhatR;
+                                    FhatR = temp;
+                                    temp = FvhatL;
+                                    FvhatL = FvhatR;
+                                    FvhatR = temp;
+                                    break;
+                                default: /* compute numerical flux at left interface */
+                                    ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], stride, field, model, FhatL);
+                                    ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], stride, dd, field, model, FvhatL);
+                                    state = 1;
+                                    break;
+                            }
+                            ComputeFhat(tn, s, k, j, i, stride, field, model, FhatR);
+                            ComputeFvhat(tn, s, k, j, i, stride, dd, field, model, FvhatR);
+                            LU(FhatR, FhatL, FvhatR, FvhatL, Phi);
+                            SolveOperator(model->multidim, s, coeA, coeB, idx, Uo, field->U[tn], field->U[tm], r[s], Phi);
+                        }
                     }
-                    switch (p) {
-                        case PHI:
-                            ComputePhi(tn, k, j, i, partn, node, model, Phi);
-                            SolveOperator(OPTSPLIT, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], dt, Phi);
-                            continue;
-                        default:
-                            break;
+                }
+            }
+            #pragma omp master
+            if (PHI != p) {
+                StopKernel(RFSWEEP + s);
+                StopRegion(RGSWEEP + s);
+            }
+        }
+    }
+    for (int s = sM; (s < sN) && (PHI != p); ++s) {
+        CountSweepCost(s, field->run[s].nodeN, model);
+    }
+    return;
+}
+/*
+ * Pencil kernel: the numerical fluxes at all interfaces of a fluid span are
+ * first computed into contiguous buffers, then the flux difference and the
+ * solution operator are applied in a second loop over the span nodes.
+ * Spans exclude solid nodes beforehand, which keeps both loops free of data
+ * dependent control flow. The fluxes of fluid nodes are identical to those
+ * of the node kernel.
+ * Pencils are processed in tiles. For the y and z sweeps, the field data
+ * of a tile, including the transverse neighbours required by diffusive
+ * fluxes, are gathered into a scratch space in which the sweep direction
+ * has unit stride, so the flux stencils access memory as in the x sweep.
+ * Updated values are written back to the field in the second pass.
+ */
+static void PencilLLLU(const Real dt, const Real coeA, const Real coeB, const int to,
+        const int tn, const int tm, const int p, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    const IntVec partn = {part->n[X], part->n[Y], part->n[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
+    FdReal *const *const Uo = (NONE == to) ? NULL : field->U[to]; /* NULL for the increment form */
+    const int stride[DIMS+1] = {1, partn[X], partn[X] * partn[Y], 0}; /* strides of the field */
+    const int bufN = MaxInt(partn[X], MaxInt(partn[Y], partn[Z])) + 1; /* interfaces of a pencil */
+    const int tileN = bufN * (PENCILTILE + 2) * (PENCILTILE + 2); /* nodes of a tile */
+    int sM = 0, sN = 0; /* space sweep control for the operator p */
+    switch (p) {
+        case DIMS: /* all spatial operators */
+            sM = 0; sN = DIMS;
+            break;
+        default: /* individual spatial operator */
+            sM = p; sN = sM + 1;
+            break;
+    }
+    #pragma omp parallel
+    {
+        int i = 0, j = 0, k = 0; /* index with normal order */
+        Real Phi[DIMU] = {0.0}; /* right hand side vector */
+        Real *const buf = AssignStorage(2 * bufN * DIMU * sizeof(*buf), MEMSCRATCH);
+        Real (*restrict Fhat)[DIMU] = (Real (*)[DIMU])buf; /* numerical convective fluxes of pencil interfaces */
+        Real (*restrict Fvhat)[DIMU] = (Real (*)[DIMU])(buf + bufN * DIMU); /* numerical diffusive fluxes of pencil interfaces */
+        FdReal *const tbuf = AssignStorage(DIMU * tileN * sizeof(*tbuf), MEMSCRATCH);
+        Field tile = {0}; /* field data of a tile of pencils */
+        for (int n = 0; n < DIMU; ++n) {
+            tile.U[tn][n] = tbuf + n * tileN;
+        }
+        /* space sweep with dimension priority */
+        for (int s = sM; s < sN; ++s) {
+            const Run *const run = field->run + s;
+            const int jM = part->np[s][Y][MIN];
+            const int jN = part->np[s][Y][MAX];
+            const int kM = part->np[s][Z][MIN];
+            const int kN = part->np[s][Z][MAX];
+            /* physical dimensions of the sweep, pencil rows, and pencil layers */
+            const int dim[DIMS] = {s, (X == s) ? Y : X, (Z == s) ? Y : Z};
+            #pragma omp master
+            {
+                StartRegion(RGSWEEP + s);
+                StartKernel(RFSWEEP + s);
+            }
+            #pragma omp for collapse(2) schedule(static)
+            for (int kt = kM; kt < kN; kt = kt + PENCILTILE) {
+                for (int jt = jM; jt < jN; jt = jt + PENCILTILE) {
+                    const int ktN = MinInt(kt + PENCILTILE, kN);
+                    const int jtN = MinInt(jt + PENCILTILE, jN);
+                    const Field *view = field; /* field data read by flux stencils */
+                    const int *vstride = stride;
+                    int tstride[DIMS+1] = {0}; /* strides of the tile */
+                    if (X != s) {
+                        /* node box of the tile along each physical dimension */
+                        int box[DIMS][LIMIT] = {{0}};
+                        box[dim[0]][MIN] = 0;
+                        box[dim[0]][MAX] = partn[dim[0]];
+                        box[dim[1]][MIN] = MaxInt(jt - 1, 0);
+                        box[dim[1]][MAX] = MinInt(jtN + 1, partn[dim[1]]);
+                        box[dim[2]][MIN] = MaxInt(kt - 1, 0);
+                        box[dim[2]][MAX] = MinInt(ktN + 1, partn[dim[2]]);
+                        tstride[dim[0]] = 1;
+                        tstride[dim[1]] = partn[dim[0]];
+                        tstride[dim[2]] = partn[dim[0]] * (box[dim[1]][MAX] - box[dim[1]][MIN]);
+                        tstride[DIMS] = -(box[dim[1]][MIN] * tstride[dim[1]] + box[dim[2]][MIN] * tstride[dim[2]]);
+                        GatherTile(field->U[tn], box, partn, tstride, tile.U[tn]);
+                        view = &tile;
+                        vstride = tstride;
                     }
-                    switch (state) {
-                        case 1: /* inherit numerical flux from the previous node */
-                            temp = FhatL;
-                            FhatL = FhatR;
-                            FhatR = temp;
-                            temp = FvhatL;
-                            FvhatL = FvhatR;
-                            FvhatR = temp;
-                            break;
-                        default: /* compute numerical flux at left interface */
-                            ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, FhatL);
-                            ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, FvhatL);
-                            state = 1;
-                            break;
+                    for (int ks = kt; ks < ktN; ++ks) {
+                        for (int js = jt; js < jtN; ++js) {
+                            const int pen = (ks - kM) * (jN - jM) + (js - jM);
+                            for (int n = run->head[pen]; n < run->head[pen+1]; ++n) {
+                                const int aM = run->span[n][MIN]; /* first node of the span */
+                                const int aN = run->span[n][MAX]; /* end node of the span */
+                                /* pass one: interface q of the span is at the right of node aM - 1 + q */
+                                for (int is = aM - 1, q = 0; is < aN; ++is, ++q) {
+                                    switch (s) {
+                                        case X:
+                                            i = is; j = js; k = ks;
+                                            break;
+                                        case Y:
+                                            i = js; j = is; k = ks;
+                                            break;
+                                        case Z:
+                                            i = js; j = ks; k = is;
+                                            break;
+                                        default:
+                                            break;
+                                    }
+                                    if (0 == q % WENOBATCH) { /* convective fluxes are reconstructed in batches */
+                                        ComputeFhatBatch(tn, s, k, j, i, MinInt(WENOBATCH, aN - is), vstride, view, model, Fhat + q);
+                                    }
+                                    ComputeFvhat(tn, s, k, j, i, vstride, dd, view, model, Fvhat[q]);
+                                }
+                                /* pass two: flux difference and solution operator */
+                                for (int is = aM, q = 1; is < aN; ++is, ++q) {
+                                    switch (s) {
+                                        case X:
+                                            i = is; j = js; k = ks;
+                                            break;
+                                        case Y:
+                                            i = js; j = is; k = ks;
+                                            break;
+                                        case Z:
+                                            i = js; j = ks; k = is;
+                                            break;
+                                        default:
+                                            break;
+                                    }
+                                    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
+                                    LU(Fhat[q], Fhat[q-1], Fvhat[q], Fvhat[q-1], Phi);
+                                    SolveOperator(model->multidim, s, coeA, coeB, idx, Uo, field->U[tn], field->U[tm], r[s], Phi);
+                                }
+                            }
+                        }
                     }
-                    ComputeFhat(tn, s, k, j, i, partn, node, model, FhatR);
-                    ComputeFvhat(tn, s, k, j, i, partn, dd, node, model, FvhatR);
-                    LU(FhatR, FhatL, FvhatR, FvhatL, Phi);
-                    SolveOperator(model->multidim, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], r[s], Phi);
+                }
+            }
+            #pragma omp master
+            {
+                StopKernel(RFSWEEP + s);
+                StopRegion(RGSWEEP + s);
+            }
+        }
+        RetrieveStorage(tbuf);
+        RetrieveStorage(buf);
+    }
+    for (int s = sM; s < sN; ++s) {
+        CountSweepCost(s, field->run[s].nodeN, model);
+    }
+    return;
+}
+/*
+ * Gather the field data in the node box into a tile with the given strides.
+ * Rows along x are read contiguously from the field.
+ */
+static void GatherTile(FdReal *const U[restrict], int box[restrict][LIMIT], const int partn[restrict],
+        const int tstride[restrict], FdReal *const T[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                const int idx = IndexNode(k, j, 0, partn[Y], partn[X]);
+                const int tdx = IndexStride(k, j, 0, tstride);
+                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                    T[n][tdx+i*tstride[X]] = U[n][idx+i];
                 }
             }
         }
@@ -250,25 +545,35 @@ static void LU(const Real FhatR[restrict], const Real FhatL[restrict],
 }
 /*
  * Solve the solution operator for time integration.
- * Note: Uo, Un, and Um are all restricted pointers. Under the condition that
- * Un and Um NEVER alias each other, Uo and Un may alias safely since they only
- * read elements and never modify any elements. Uo and Um may alias safely
- * since Uo only fetch the single element that Um modifies later.
+ * Note: Uo, Un, and Um are the field arrays of the time levels involved and
+ * only the elements at node idx are accessed. Under the condition that the
+ * arrays of Un and Um NEVER alias each other, Uo and Un may alias safely since
+ * they only read elements and never modify any elements. Uo and Um may alias
+ * safely since Uo only fetch the single element that Um modifies later.
+ * A NULL Uo selects the increment form of low-storage schemes, in which Um
+ * is scaled by coeA rather than replaced: Um = coeA * Um + coeB * r * Phi.
  */
 static void SolveOperator(const int p, const int s, const Real coeA, const Real coeB,
-        const Real Uo[restrict], const Real Un[restrict], Real Um[restrict], const Real r,
-        const Real Phi[restrict])
+        const int idx, FdReal *const Uo[restrict], FdReal *const Un[restrict],
+        FdReal *const Um[restrict], const Real r, const Real Phi[restrict])
 {
     /* accumulation step for operator-by-operator approximation */
     if ((OPTBYOPT == p) && (X != s)) {
         for (int n = 0; n < DIMU; ++n) {
-            Um[n] = Um[n] + coeB * r * Phi[n];
+            Um[n][idx] = Um[n][idx] + coeB * r * Phi[n];
+        }
+        return;
+    }
+    /* solve step for the increment form */
+    if (NULL == Uo) {
+        for (int n = 0; n < DIMU; ++n) {
+            Um[n][idx] = coeA * Um[n][idx] + coeB * r * Phi[n];
         }
         return;
     }
     /* solve step for the solution operator */
     for (int n = 0; n < DIMU; ++n) {
-        Um[n] = coeA * Uo[n] + coeB * (Un[n] + r * Phi[n]);
+        Um[n][idx] = coeA * Uo[n][idx] + coeB * (Un[n][idx] + r * Phi[n]);
     }
     return;
 }
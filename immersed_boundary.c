@@ -18,6 +18,8 @@
 #include <float.h> /* size of floating point values */
 #include <string.h> /* manipulating strings */
 #include "computational_geometry.h"
+#include "message_passing.h"
+#include "roofline.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -34,20 +36,41 @@ typedef enum {
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void InitializeGeometricField(Space *);
+static int MarkRemap(const int, Space *, const Model *);
+static int SetRemapBand(const int, Space *, int [restrict][DIMS][LIMIT]);
+static int MergeBand(int, int [restrict][DIMS][LIMIT]);
+static int FindRoot(int, int [restrict]);
+static int SetBoxRow(const int, int [restrict][DIMS][LIMIT], int [restrict]);
+static int LocateRow(const int, const int, const int [restrict]);
+static void InitializeGeometricField(const int, int [restrict][DIMS][LIMIT], Space *);
 static void SetDomainField(Space *);
-static void SetInterfacialField(Space *, const Model *);
+static int ColorGeometry(const int, int [restrict][DIMS][LIMIT], int [restrict], int [restrict]);
+static int CompareStart(const void *, const void *);
+static void MapSphereRow(const int, const int, const int, const int [restrict],
+        const Polyhedron *, const Partition *const, Field *const);
+static void MapPolyhedronRow(const int, const int, const int, const int [restrict],
+        const Polyhedron *, const Partition *const, Field *const, int [restrict], Real *[restrict]);
+static void SetInterfacialField(const int, int [restrict][DIMS][LIMIT], Space *, const Model *);
+static void SetFluidRun(const int, const int, int [restrict][DIMS][LIMIT], Space *);
+static int CompareIndex(const void *, const void *);
 static int GetInterState(const int, const int, const int, const int, const int,
-        const int, const int [restrict][DIMS], const Node *const, const Partition *const);
-static void ApplyWeighting(const Real [restrict], const Real, Real,
-        Real [restrict], Real [restrict]);
+        const int, const int [restrict][DIMS], const Field *const, const Partition *const);
+static void SetInterfacialList(Space *);
+static void SetGhostStencil(Space *, const Model *);
+static int SearchStencil(const int [restrict], const int, const int, const int,
+        const Partition *const, const Field *const, int *);
+static int ScanStencil(const int [restrict], const Real [restrict], const int, const int,
+        const int, const Partition *const, const Field *const, int [restrict], Real [restrict]);
+static int InStencil(const int, const int, const int, const Field *const);
+static Real ComputeWeight(const Real, Real);
+static void ApplyWeighting(const Real [restrict], const Real, Real [restrict], Real [restrict]);
 static Real InverseDistanceWeighting(const int, const int [restrict],
         const Real [restrict], const int, const int, const int, const Partition *const,
-        const Node *const, const Model *, Real [restrict]);
-static void ReconstructFlow(const int, const int [restrict], const Real [restrict],
-        const int, const int, const int, const Polyhedron *, const Partition *const,
-        const Node *const, const Model *, const Real [restrict], const Real [restrict],
-        Real [restrict], Real [restrict]);
+        const Field *const, const Model *, Real [restrict]);
+static Real WeightStencil(const int, const Ghost *, const Interface *, const Field *const,
+        const Model *, Real [restrict]);
+static void ReconstructFlow(const int, const Ghost *, const Interface *, const Polyhedron *,
+        const Field *const, const Model *, Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -61,56 +84,416 @@ static void ReconstructFlow(const int, const int [restrict], const Real [restric
  * access the geometry for computing future required geometric data.
  * The rational is that do not store every information for each node, but
  * only store necessary links. When need it, access and calculate it.
+ *
+ * An update only remaps polyhedrons drifted enough since their last node
+ * mapping, and only visits the band of nodes around their old and new
+ * positions, out of which the geometric field does not change. An update
+ * without such polyhedrons is skipped. The first update maps the domain.
  */
 void ComputeGeometricField(Space *space, const Model *model)
 {
-    InitializeGeometricField(space);
+    Field *const field = &(space->field);
+    Interface *const ibm = &(field->ibm);
+    const int first = (NULL == field->run[X].head); /* runs are set by the first update */
+    if ((0 == MarkRemap(first, space, model)) && (0 == first)) {
+        return;
+    }
+    int (*band)[DIMS][LIMIT] = AssignStorage((space->geo.totN + 1) * sizeof(*band), MEMSCRATCH);
+    const int bandN = SetRemapBand(first, space, band);
+    InitializeGeometricField(bandN, band, space);
     SetDomainField(space);
-    SetInterfacialField(space, model);
+    ExchangeGeometricField(space);
+    SetInterfacialField(bandN, band, space, model);
+    ExchangeGeometricField(space);
+    ExchangeFieldData(TO, space);
+    for (int s = 0; s < DIMS; ++s) {
+        SetFluidRun(s, bandN, band, space);
+    }
+    SetGhostStencil(space, model);
+    /* keep the band to remove its domain change marks in the next update */
+    if (bandN > ibm->bandMax) {
+        ibm->bandMax = bandN;
+        if (NULL == ibm->band) {
+            ibm->band = AssignStorage(ibm->bandMax * sizeof(*ibm->band), MEMFIELD);
+        } else {
+            ibm->band = ReassignStorage(ibm->band, ibm->bandMax * sizeof(*ibm->band));
+        }
+    }
+    memcpy(ibm->band, band, bandN * sizeof(*band));
+    ibm->bandN = bandN;
+    RetrieveStorage(band);
     return;
 }
-static void InitializeGeometricField(Space *space)
+/*
+ * A polyhedron is remapped once the drift of its surface reaches the remap
+ * tolerance in mesh sizes. Stationary polyhedrons keep their nodes, and the
+ * first update maps every polyhedron. A nonzero tolerance trades accuracy
+ * for speed: until remapped, a moving polyhedron keeps the node flags, ghost
+ * geometry and stencils of its last mapping, while ghost states and surface
+ * forces take its current motion, so its boundary lags by up to the
+ * tolerance. A zero tolerance remaps every moving polyhedron at each update.
+ */
+static int MarkRemap(const int first, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    const Geometry *const geo = &(space->geo);
-    const Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
-    int gid = 0; /* store geometry identifier */
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                gid = node[idx].did;
-                node[idx].gst = node[idx].did; /* preserve domain field */
-                if (0 == gid) {
-                    node[idx].fid = 0; /* remove passe domain change mark */
-                    continue; /* skip non-polyhedron nodes */
-                }
-                /* the rest is to treat polyhedron nodes */
-                poly = geo->poly + gid - 1;
-                if (1 == poly->state) {
-                    continue; /* keep domain field for nodes in stationary polyhedron */
-                }
-                /*
-                 * The rest is to treat nodes in non-stationary polyhedrons. Due
-                 * to the restricted motion, can only reset interfacial nodes for
-                 * remapping while keeping non-interfacial nodes to reduce cost.
-                 * When polyhedrons move, the previous nth layer may become a
-                 * (n-1)th layer, therefore, need to reset gl+1 layers to
-                 * ensure the closest face id information of all the future
-                 * gl interfacial nodes are updated. However, if only need to
-                 * update the closest face id information for the future gl-1
-                 * layers, can only reset gl interfacial layers.
-                 */
-                if (0 < node[idx].lid) {
-                    node[idx].did = 0;
+    Geometry *const geo = &(space->geo);
+    const Real tol = model->remapTol * MinReal(part->d[X], MinReal(part->d[Y], part->d[Z]));
+    Polyhedron *poly = NULL;
+    int remapN = 0;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        poly->remap = (0 != first) || ((1 != poly->state) && (tol <= poly->drift));
+        remapN = remapN + poly->remap;
+    }
+    return remapN;
+}
+/*
+ * Nodes of a remapped polyhedron are in its node boxes at the last and the
+ * current mapping, and the interfacial state of a node only depends on the
+ * nodes within gl layers around it. Hence the band of an update is the union
+ * of these boxes widened by gl layers, which is merged into disjoint boxes
+ * for each node to be visited once.
+ */
+static int SetRemapBand(const int first, Space *space, int band[restrict][DIMS][LIMIT])
+{
+    const Partition *const part = &(space->part);
+    Geometry *const geo = &(space->geo);
+    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
+    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    Polyhedron *poly = NULL;
+    int bandN = 0;
+    if (0 != first) {
+        for (int s = 0; s < DIMS; ++s) {
+            band[bandN][s][MIN] = nMin[s];
+            band[bandN][s][MAX] = nMax[s];
+        }
+        ++bandN;
+    }
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (0 == poly->remap) {
+            continue;
+        }
+        if (0 == first) {
+            for (int s = 0; s < DIMS; ++s) {
+                band[bandN][s][MIN] = MaxInt(nMin[s], MapNode(MinReal(poly->mbox[s][MIN], poly->box[s][MIN]),
+                            sMin[s], dd[s], n0[s]) - part->gl);
+                band[bandN][s][MAX] = MinInt(nMax[s], MapNode(MaxReal(poly->mbox[s][MAX], poly->box[s][MAX]),
+                            sMin[s], dd[s], n0[s]) + part->gl + 1);
+            }
+            if ((band[bandN][X][MIN] < band[bandN][X][MAX]) && (band[bandN][Y][MIN] < band[bandN][Y][MAX]) &&
+                    (band[bandN][Z][MIN] < band[bandN][Z][MAX])) {
+                ++bandN;
+            }
+        }
+        memcpy(poly->mbox, poly->box, DIMS * sizeof(*poly->box));
+        poly->drift = 0.0;
+    }
+    return MergeBand(bandN, band);
+}
+/*
+ * Overlapping boxes are found by sorting the boxes on their lower bound in
+ * x and sweeping, and each group of overlapping boxes is replaced by its
+ * bounding box. Merged boxes may overlap other boxes, so this repeats until
+ * the boxes are disjoint.
+ */
+static int MergeBand(int bandN, int band[restrict][DIMS][LIMIT])
+{
+    int (*start)[2] = AssignStorage(bandN * sizeof(*start), MEMSCRATCH); /* lower bound and box */
+    int *root = AssignStorage(bandN * sizeof(*root), MEMSCRATCH); /* group of each box */
+    for (int merge = 1; 0 != merge;) {
+        merge = 0;
+        for (int n = 0; n < bandN; ++n) {
+            start[n][0] = band[n][X][MIN];
+            start[n][1] = n;
+            root[n] = n;
+        }
+        qsort(start, bandN, sizeof(*start), CompareStart);
+        for (int a = 0; a < bandN; ++a) {
+            const int p = start[a][1];
+            for (int b = a + 1; (b < bandN) && (start[b][0] < band[p][X][MAX]); ++b) {
+                const int q = start[b][1];
+                if ((band[p][Y][MIN] >= band[q][Y][MAX]) || (band[q][Y][MIN] >= band[p][Y][MAX]) ||
+                        (band[p][Z][MIN] >= band[q][Z][MAX]) || (band[q][Z][MIN] >= band[p][Z][MAX])) {
+                    continue;
                 }
+                const int rp = FindRoot(p, root);
+                const int rq = FindRoot(q, root);
+                root[MaxInt(rp, rq)] = MinInt(rp, rq);
+                merge = 1;
+            }
+        }
+        if (0 == merge) {
+            continue;
+        }
+        /* a group is rooted at its lowest box, which takes the bounding box */
+        for (int n = 0; n < bandN; ++n) {
+            const int r = FindRoot(n, root);
+            for (int s = 0; (r != n) && (s < DIMS); ++s) {
+                band[r][s][MIN] = MinInt(band[r][s][MIN], band[n][s][MIN]);
+                band[r][s][MAX] = MaxInt(band[r][s][MAX], band[n][s][MAX]);
+            }
+        }
+        int m = 0;
+        for (int n = 0; n < bandN; ++n) {
+            if (n == root[n]) {
+                memcpy(band[m], band[n], sizeof(*band));
+                ++m;
+            }
+        }
+        bandN = m;
+    }
+    RetrieveStorage(root);
+    RetrieveStorage(start);
+    return bandN;
+}
+static int FindRoot(int n, int root[restrict])
+{
+    while (root[n] != n) {
+        root[n] = root[root[n]]; /* path halving */
+        n = root[n];
+    }
+    return n;
+}
+/*
+ * Rows of node boxes are numbered box by box, and row t of box b is the row
+ * (k, j) = (kM + (t - row[b]) / (jN - jM), jM + (t - row[b]) % (jN - jM)).
+ */
+static int SetBoxRow(const int boxN, int box[restrict][DIMS][LIMIT], int row[restrict])
+{
+    row[0] = 0;
+    for (int b = 0; b < boxN; ++b) {
+        row[b+1] = row[b] + (box[b][Z][MAX] - box[b][Z][MIN]) * (box[b][Y][MAX] - box[b][Y][MIN]);
+    }
+    return row[boxN];
+}
+/*
+ * The box of a row is the last box starting at or before the row, which is
+ * found by bisection.
+ */
+static int LocateRow(const int t, const int boxN, const int row[restrict])
+{
+    int lo = 0;
+    int hi = boxN - 1;
+    while (lo < hi) {
+        const int mid = (lo + hi + 1) / 2;
+        if (row[mid] <= t) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+/*
+ * Domain change marks of the last update are removed in its band, and the
+ * geometric field is prepared for remapping in the band of this update.
+ */
+static void InitializeGeometricField(const int bandN, int band[restrict][DIMS][LIMIT], Space *space)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
+    Interface *const ibm = &(field->ibm);
+    int *row = AssignStorage((MaxInt(bandN, ibm->bandN) + 1) * sizeof(*row), MEMSCRATCH); /* first row of each box */
+    int rowN = SetBoxRow(ibm->bandN, ibm->band, row);
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < rowN; ++t) {
+        const int b = LocateRow(t, ibm->bandN, row);
+        const int jN = ibm->band[b][Y][MAX] - ibm->band[b][Y][MIN];
+        const int k = ibm->band[b][Z][MIN] + (t - row[b]) / jN;
+        const int j = ibm->band[b][Y][MIN] + (t - row[b]) % jN;
+        for (int i = ibm->band[b][X][MIN]; i < ibm->band[b][X][MAX]; ++i) {
+            const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+            if (0 == field->did[idx]) {
+                field->fid[idx] = 0; /* remove passe domain change mark */
             }
         }
     }
+    rowN = SetBoxRow(bandN, band, row);
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < rowN; ++t) {
+        const int b = LocateRow(t, bandN, row);
+        const int jN = band[b][Y][MAX] - band[b][Y][MIN];
+        const int k = band[b][Z][MIN] + (t - row[b]) / jN;
+        const int j = band[b][Y][MIN] + (t - row[b]) % jN;
+        for (int i = band[b][X][MIN]; i < band[b][X][MAX]; ++i) {
+            const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+            const int gid = field->did[idx]; /* store geometry identifier */
+            field->gst[idx] = field->did[idx]; /* preserve domain field */
+            if (0 == gid) {
+                field->fid[idx] = 0; /* remove passe domain change mark */
+                continue; /* skip non-polyhedron nodes */
+            }
+            /* the rest is to treat polyhedron nodes */
+            const Polyhedron *poly = geo->poly + gid - 1;
+            if (0 == poly->remap) {
+                continue; /* keep domain field for nodes in polyhedron not remapped */
+            }
+            /*
+             * The rest is to treat nodes in remapped polyhedrons. Due
+             * to the restricted motion, can only reset interfacial nodes for
+             * remapping while keeping non-interfacial nodes to reduce cost.
+             * When polyhedrons move, the previous nth layer may become a
+             * (n-1)th layer, therefore, need to reset gl+1 layers to
+             * ensure the closest face id information of all the future
+             * gl interfacial nodes are updated. However, if only need to
+             * update the closest face id information for the future gl-1
+             * layers, can only reset gl interfacial layers.
+             */
+            if (0 < field->lid[idx]) {
+                field->did[idx] = 0;
+            }
+        }
+    }
+    RetrieveStorage(row);
+    return;
+}
+/*
+ * Pencils along direction s are the node lines of the computational range
+ * np[s], and pencil (ks, js) is numbered (ks - kM) * (jN - jM) + (js - jM).
+ * Spans are maximal ranges of fluid nodes, which are the nodes solved by
+ * the spatial operators. Only the pencils crossing the band of an update
+ * are scanned again, and the spans of the pencils between two of them are
+ * shifted as a block by the change of span counts of the former pencils,
+ * which is skipped if no count changes.
+ */
+static void SetFluidRun(const int s, const int bandN, int band[restrict][DIMS][LIMIT], Space *space)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    Run *const run = field->run + s;
+    const int iM = part->np[s][X][MIN];
+    const int iN = part->np[s][X][MAX];
+    const int jM = part->np[s][Y][MIN];
+    const int jN = part->np[s][Y][MAX];
+    const int kM = part->np[s][Z][MIN];
+    const int kN = part->np[s][Z][MAX];
+    const int pencilN = (jN - jM) * (kN - kM);
+    /* strides of the pencil, row, and layer dimensions */
+    const int stride[DIMS] = {1, part->n[X], part->n[X] * part->n[Y]};
+    const int dim[DIMS] = {s, (X == s) ? Y : X, (Z == s) ? Y : Z};
+    const int si = stride[dim[0]];
+    const int sj = stride[dim[1]];
+    const int sk = stride[dim[2]];
+    if (NULL == run->head) {
+        run->head = AssignStorage((pencilN + 1) * sizeof(*run->head), MEMFIELD);
+    }
+    /* pencils crossing the band in ascending order */
+    int scanN = 0;
+    for (int b = 0; b < bandN; ++b) {
+        scanN = scanN + MaxInt(0, MinInt(kN, band[b][dim[2]][MAX]) - MaxInt(kM, band[b][dim[2]][MIN])) *
+            MaxInt(0, MinInt(jN, band[b][dim[1]][MAX]) - MaxInt(jM, band[b][dim[1]][MIN]));
+    }
+    int *scan = AssignStorage((scanN + 1) * sizeof(*scan), MEMSCRATCH);
+    scanN = 0;
+    for (int b = 0; b < bandN; ++b) {
+        for (int k = MaxInt(kM, band[b][dim[2]][MIN]); k < MinInt(kN, band[b][dim[2]][MAX]); ++k) {
+            for (int j = MaxInt(jM, band[b][dim[1]][MIN]); j < MinInt(jN, band[b][dim[1]][MAX]); ++j) {
+                scan[scanN] = (k - kM) * (jN - jM) + (j - jM);
+                ++scanN;
+            }
+        }
+    }
+    qsort(scan, scanN, sizeof(*scan), CompareIndex);
+    int m = 0;
+    for (int n = 0; n < scanN; ++n) {
+        if ((0 == m) || (scan[m-1] != scan[n])) {
+            scan[m] = scan[n];
+            ++m;
+        }
+    }
+    scanN = m;
+    /* spans of scanned pencils: count, shift of preceding counts, change of nodes */
+    int (*count)[3] = AssignStorage((scanN + 1) * sizeof(*count), MEMSCRATCH);
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < scanN; ++n) {
+        const int p = scan[n];
+        const int *did = field->did + (kM + p / (jN - jM)) * sk + (jM + p % (jN - jM)) * sj;
+        int spanN = 0;
+        int nodeN = 0;
+        for (int i = iM, fluid = 0; i < iN; ++i) {
+            spanN = spanN + ((0 == did[i*si]) && (0 == fluid));
+            fluid = (0 == did[i*si]);
+            nodeN = nodeN + fluid;
+        }
+        for (int q = run->head[p]; q < run->head[p+1]; ++q) {
+            nodeN = nodeN - (run->span[q][MAX] - run->span[q][MIN]);
+        }
+        count[n][0] = spanN;
+        count[n][2] = nodeN;
+    }
+    int shift = 0;
+    int moved = 0; /* a span count changes */
+    for (int n = 0; n < scanN; ++n) {
+        const int p = scan[n];
+        const int delta = count[n][0] - (run->head[p+1] - run->head[p]);
+        count[n][1] = shift;
+        shift = shift + delta;
+        moved = moved || (0 != delta);
+        run->nodeN = run->nodeN + count[n][2];
+    }
+    count[scanN][1] = shift;
+    /* spans behind the first scanned pencil are kept aside before shifting */
+    const int base = (0 < scanN) ? run->head[scan[0]] : 0;
+    int (*tail)[LIMIT] = AssignStorage((moved ? run->spanN - base : 0) * sizeof(*tail), MEMSCRATCH);
+    if ((0 != moved) && (run->spanN > base)) {
+        memcpy(tail, run->span + base, (run->spanN - base) * sizeof(*tail));
+    }
+    if (run->spanN + shift > run->spanMax) {
+        run->spanMax = run->spanN + shift + (run->spanN + shift) / 2; /* spare room for moving geometries */
+        if (NULL == run->span) {
+            run->span = AssignStorage(run->spanMax * sizeof(*run->span), MEMFIELD);
+        } else {
+            run->span = ReassignStorage(run->span, run->spanMax * sizeof(*run->span));
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < scanN; ++n) {
+        const int p = scan[n];
+        const int q0 = run->head[p+1];
+        const int qN = (scanN - 1 > n) ? run->head[scan[n+1]] : run->spanN;
+        if ((0 != moved) && (qN > q0)) { /* shift the pencils after the scanned pencil */
+            memcpy(run->span + q0 + count[n+1][1], tail + q0 - base, (qN - q0) * sizeof(*tail));
+        }
+        const int *did = field->did + (kM + p / (jN - jM)) * sk + (jM + p % (jN - jM)) * sj;
+        int q = run->head[p] + count[n][1];
+        for (int i = iM; i < iN; ++i) {
+            if (0 != did[i*si]) {
+                continue;
+            }
+            run->span[q][MIN] = i;
+            while ((i < iN) && (0 == did[i*si])) {
+                ++i;
+            }
+            run->span[q][MAX] = i;
+            ++q;
+        }
+    }
+    if (0 != moved) {
+        #pragma omp parallel for schedule(static)
+        for (int n = 0; n < scanN; ++n) {
+            const int pN = (scanN - 1 > n) ? scan[n+1] : pencilN;
+            for (int p = scan[n] + 1; p <= pN; ++p) {
+                run->head[p] = run->head[p] + count[n+1][1];
+            }
+        }
+    }
+    run->spanN = run->spanN + shift;
+    RetrieveStorage(tail);
+    RetrieveStorage(count);
+    RetrieveStorage(scan);
     return;
 }
+static int CompareIndex(const void *a, const void *b)
+{
+    const int ia = *(const int *)a;
+    const int ib = *(const int *)b;
+    return (ia > ib) - (ia < ib);
+}
 /*
  * In domain-node mapping, there are two approaches available. One is loop
  * over each node to verify each node regarding all the geometries; another
@@ -128,103 +511,360 @@ static void InitializeGeometricField(Space *space)
 static void SetDomainField(Space *space)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
     const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    const Polyhedron *poly = NULL;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    int fid = 0; /* store face link */
-    int idx = 0; /* linear array index math variable */
-    RealVec p = {0.0}; /* node point */
-    /* overlapping geometries introduce loop-carried dependence for node mapping */
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    int (*box)[DIMS][LIMIT] = AssignStorage(geo->totN * sizeof(*box), MEMSCRATCH); /* bounding box in node space */
+    int *order = AssignStorage(geo->totN * sizeof(*order), MEMSCRATCH); /* polyhedrons ordered by colors */
+    int *head = AssignStorage((geo->totN + 1) * sizeof(*head), MEMSCRATCH); /* first polyhedron of each color */
+    int *row = AssignStorage((geo->totN + 1) * sizeof(*row), MEMSCRATCH); /* first row of each polyhedron of a color */
     for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        if (1 == poly->state) {
-            continue;
-        }
+        const Polyhedron *poly = geo->poly + n;
         /* determine search range according to bounding box of polyhedron and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        /* find nodes in geometry, then flag and link to geometry */
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if (0 != node[idx].did) { /* already classified */
-                        continue;
-                    }
-                    p[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    if (0 >= poly->faceN) { /* analytical polyhedron */
-                        if (poly->r * poly->r >= Dist2(poly->O, p)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = 0;
-                        }
-                    } else { /* triangulated polyhedron */
-                        if (PointInPolyhedron(p, poly, &fid)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = fid;
-                        }
-                    }
+            box[n][s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], n0[s]), nMin[s], nMax[s]);
+            box[n][s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], n0[s]), nMin[s], nMax[s]) + 1;
+        }
+        if (0 == poly->remap) { /* polyhedron not remapped keeps its nodes */
+            box[n][X][MAX] = box[n][X][MIN];
+        }
+    }
+    /*
+     * Overlapping geometries introduce loop-carried dependence for node
+     * mapping, since a node is claimed by the first polyhedron containing it.
+     * Polyhedrons of the same color have disjoint boxes and are mapped
+     * concurrently, while colors are mapped in order.
+     */
+    const int colorN = ColorGeometry(geo->totN, box, head, order);
+    for (int c = 0; c < colorN; ++c) {
+        row[0] = 0;
+        for (int m = head[c]; m < head[c+1]; ++m) {
+            const int n = order[m];
+            row[m-head[c]+1] = row[m-head[c]] + (box[n][Z][MAX] - box[n][Z][MIN]) * (box[n][Y][MAX] - box[n][Y][MIN]);
+        }
+        const int rowN = row[head[c+1]-head[c]];
+        /* find nodes in geometry row by row, then flag and link to geometry */
+        #pragma omp parallel
+        {
+            int crossMax = 16; /* capacity of crossing list */
+            Real *cross = AssignStorage(crossMax * sizeof(*cross), MEMSCRATCH);
+            #pragma omp for schedule(dynamic, 4)
+            for (int t = 0; t < rowN; ++t) {
+                const int m = LocateRow(t, head[c+1] - head[c], row); /* polyhedron of current row in the color */
+                const int n = order[head[c]+m];
+                const Polyhedron *poly = geo->poly + n;
+                const int jN = box[n][Y][MAX] - box[n][Y][MIN];
+                const int k = box[n][Z][MIN] + (t - row[m]) / jN;
+                const int j = box[n][Y][MIN] + (t - row[m]) % jN;
+                if (0 >= poly->faceN) { /* analytical polyhedron */
+                    MapSphereRow(n, k, j, box[n][X], poly, part, field);
+                } else { /* triangulated polyhedron */
+                    MapPolyhedronRow(n, k, j, box[n][X], poly, part, field, &crossMax, &cross);
                 }
             }
+            RetrieveStorage(cross);
+        }
+    }
+    RetrieveStorage(row);
+    RetrieveStorage(head);
+    RetrieveStorage(order);
+    RetrieveStorage(box);
+    return;
+}
+/*
+ * A polyhedron takes the color next to the highest color of the lower
+ * numbered polyhedrons whose boxes overlap its box, so every polyhedron
+ * sharing nodes with it and numbered before it is mapped in an earlier
+ * color, which reproduces the sequential mapping. Overlapping pairs are
+ * found by sorting the boxes on their lower bound in x and sweeping. The
+ * polyhedrons of each color are ordered by their numbers. Empty boxes take
+ * no color.
+ */
+static int ColorGeometry(const int totN, int box[restrict][DIMS][LIMIT], int head[restrict], int order[restrict])
+{
+    int (*start)[2] = AssignStorage(totN * sizeof(*start), MEMSCRATCH); /* lower bound and polyhedron */
+    int *color = AssignStorage(totN * sizeof(*color), MEMSCRATCH);
+    int pairMax = totN + 16; /* capacity of the pair list */
+    int (*pair)[2] = AssignStorage(pairMax * sizeof(*pair), MEMSCRATCH); /* higher and lower polyhedron */
+    int pairN = 0;
+    int colorN = 0;
+    int startN = 0;
+    for (int n = 0; n < totN; ++n) {
+        color[n] = NONE;
+        if ((box[n][X][MIN] >= box[n][X][MAX]) || (box[n][Y][MIN] >= box[n][Y][MAX]) ||
+                (box[n][Z][MIN] >= box[n][Z][MAX])) {
+            continue;
+        }
+        start[startN][0] = box[n][X][MIN];
+        start[startN][1] = n;
+        ++startN;
+    }
+    qsort(start, startN, sizeof(*start), CompareStart);
+    for (int a = 0; a < startN; ++a) {
+        const int p = start[a][1];
+        for (int b = a + 1; (b < startN) && (start[b][0] < box[p][X][MAX]); ++b) {
+            const int q = start[b][1];
+            if ((box[p][Y][MIN] >= box[q][Y][MAX]) || (box[q][Y][MIN] >= box[p][Y][MAX]) ||
+                    (box[p][Z][MIN] >= box[q][Z][MAX]) || (box[q][Z][MIN] >= box[p][Z][MAX])) {
+                continue;
+            }
+            if (pairN == pairMax) {
+                pairMax = 2 * pairMax;
+                pair = ReassignStorage(pair, pairMax * sizeof(*pair));
+            }
+            pair[pairN][0] = MaxInt(p, q);
+            pair[pairN][1] = MinInt(p, q);
+            ++pairN;
+        }
+    }
+    qsort(pair, pairN, sizeof(*pair), CompareStart);
+    for (int n = 0, m = 0; n < totN; ++n) {
+        if ((box[n][X][MIN] < box[n][X][MAX]) && (box[n][Y][MIN] < box[n][Y][MAX]) &&
+                (box[n][Z][MIN] < box[n][Z][MAX])) {
+            color[n] = 0;
+        }
+        for (; (m < pairN) && (n == pair[m][0]); ++m) {
+            color[n] = MaxInt(color[n], color[pair[m][1]] + 1);
+        }
+        colorN = MaxInt(colorN, color[n] + 1);
+    }
+    /* order polyhedrons by colors */
+    memset(head, 0, (colorN + 1) * sizeof(*head));
+    for (int n = 0; n < totN; ++n) {
+        if (NONE != color[n]) {
+            ++head[color[n]+1];
+        }
+    }
+    for (int c = 0; c < colorN; ++c) {
+        head[c+1] = head[c+1] + head[c];
+    }
+    for (int n = 0; n < totN; ++n) {
+        if (NONE != color[n]) {
+            order[head[color[n]]] = n;
+            ++head[color[n]];
+        }
+    }
+    for (int c = colorN; c > 0; --c) {
+        head[c] = head[c-1];
+    }
+    head[0] = 0;
+    RetrieveStorage(pair);
+    RetrieveStorage(color);
+    RetrieveStorage(start);
+    return colorN;
+}
+static int CompareStart(const void *a, const void *b)
+{
+    const int *const sa = a;
+    const int *const sb = b;
+    if (sa[0] != sb[0]) {
+        return (sa[0] < sb[0]) ? -1 : 1;
+    }
+    return (sa[1] < sb[1]) ? -1 : ((sa[1] > sb[1]) ? 1 : 0);
+}
+/*
+ * Nodes of a row inside a sphere form a range around the node closest to the
+ * center, since the distance to the center is monotone along the row. The
+ * range is estimated analytically and its ends are settled by the inclusion
+ * test of nodes, so the result equals testing every node.
+ */
+static void MapSphereRow(const int n, const int k, const int j, const int box[restrict],
+        const Polyhedron *poly, const Partition *const part, Field *const field)
+{
+    const Real sMin = part->domain[X][MIN];
+    const Real d = part->d[X];
+    const int n0 = part->n0[X];
+    RealVec p = {0.0}; /* node point */
+    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]);
+    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z]);
+    const Real r2 = poly->r * poly->r;
+    const int ic = ConfineSpace(MapNode(poly->O[X], sMin, part->dd[X], n0), box[MIN], box[MAX]);
+    p[X] = MapPoint(ic, sMin, d, n0);
+    if (r2 < Dist2(poly->O, p)) {
+        return; /* the row does not cut the sphere */
+    }
+    const Real rem = r2 - (p[Y] - poly->O[Y]) * (p[Y] - poly->O[Y]) - (p[Z] - poly->O[Z]) * (p[Z] - poly->O[Z]);
+    const Real half = sqrt(MaxReal(rem, 0.0));
+    int lo = MinInt(ic, ConfineSpace(MapNode(poly->O[X] - half, sMin, part->dd[X], n0), box[MIN], box[MAX]));
+    int hi = MaxInt(ic, ConfineSpace(MapNode(poly->O[X] + half, sMin, part->dd[X], n0), box[MIN], box[MAX]));
+    for (p[X] = MapPoint(lo, sMin, d, n0); r2 < Dist2(poly->O, p); p[X] = MapPoint(lo, sMin, d, n0)) {
+        ++lo;
+    }
+    for (p[X] = MapPoint(lo - 1, sMin, d, n0); (box[MIN] < lo) && (r2 >= Dist2(poly->O, p));
+            p[X] = MapPoint(lo - 1, sMin, d, n0)) {
+        --lo;
+    }
+    for (p[X] = MapPoint(hi, sMin, d, n0); r2 < Dist2(poly->O, p); p[X] = MapPoint(hi, sMin, d, n0)) {
+        --hi;
+    }
+    for (p[X] = MapPoint(hi + 1, sMin, d, n0); (box[MAX] - 1 > hi) && (r2 >= Dist2(poly->O, p));
+            p[X] = MapPoint(hi + 1, sMin, d, n0)) {
+        ++hi;
+    }
+    for (int i = lo; i <= hi; ++i) {
+        const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+        if (0 != field->did[idx]) { /* already classified */
+            continue;
         }
+        field->did[idx] = n + 1;
+        field->fid[idx] = 0;
     }
     return;
 }
-static void SetInterfacialField(Space *space, const Model *model)
+/*
+ * The crossings of a row with the faces of a polyhedron split the row into
+ * segments of uniform inclusion, which follows from the first node of a
+ * segment tested farther than a mesh size from the crossings. Nodes of a
+ * grazing row are all tested. Otherwise, the rest of an outside segment is
+ * skipped, and the rest of an inside segment is flagged without a test and
+ * left unlinked to faces. Nodes within a mesh size of the crossings are
+ * tested and linked to their closest faces. The unlinked nodes that turn
+ * out to be interfacial are linked by SetInterfacialField, hence the tests
+ * scale with the surface rather than with the volume.
+ */
+static void MapPolyhedronRow(const int n, const int k, const int j, const int box[restrict],
+        const Polyhedron *poly, const Partition *const part, Field *const field,
+        int crossMax[restrict], Real *cross[restrict])
+{
+    const Real sMin = part->domain[X][MIN];
+    const Real d = part->d[X];
+    const int n0 = part->n0[X];
+    RealVec p = {0.0}; /* node point */
+    p[X] = MapPoint(box[MIN], sMin, d, n0);
+    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]);
+    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z]);
+    int crossN = LineCrossPolyhedron(p, d, poly, *crossMax, *cross);
+    if (*crossMax < crossN) {
+        *crossMax = crossN;
+        *cross = ReassignStorage(*cross, crossN * sizeof(**cross));
+        crossN = LineCrossPolyhedron(p, d, poly, *crossMax, *cross);
+    }
+    const Real *const x = *cross;
+    const int graze = (NONE == crossN) ? 1 : 0; /* test every node of a grazing row */
+    crossN = MaxInt(crossN, 0);
+    int state = NONE; /* inclusion of current segment */
+    for (int i = box[MIN], c = 0; i < box[MAX]; ++i) {
+        p[X] = MapPoint(i, sMin, d, n0);
+        while ((c < crossN) && (x[c] < p[X])) { /* enter a new segment */
+            ++c;
+            state = NONE;
+        }
+        const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+        if (0 != field->did[idx]) { /* already classified */
+            continue;
+        }
+        /* distance to the closest crossing */
+        Real gap = FLT_MAX;
+        if (c < crossN) {
+            gap = x[c] - p[X];
+        }
+        if (0 < c) {
+            gap = MinReal(gap, p[X] - x[c-1]);
+        }
+        if ((0 == graze) && (0 == state) && (d <= gap)) { /* in an outside segment */
+            continue;
+        }
+        if ((0 == graze) && (0 < state) && (d <= gap)) { /* deep in an inside segment */
+            field->did[idx] = n + 1;
+            field->fid[idx] = NONE; /* linked to a face once it is an interfacial node */
+            continue;
+        }
+        int fid = 0; /* store face link */
+        const int in = PointInPolyhedron(p, poly, &fid);
+        if ((0 == graze) && (NONE == state) && (d <= gap)) {
+            state = in;
+        }
+        if (0 != in) {
+            field->did[idx] = n + 1;
+            field->fid[idx] = fid;
+        }
+    }
+    return;
+}
+static void SetInterfacialField(const int bandN, int band[restrict][DIMS][LIMIT], Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
+    Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
     const int sd = 0; /* solution domain */
-    IntVec n = {0}; /* current node */
-    RealVec p = {0.0}; /* node point */
-    Real Uo[DIMUo] = {0.0};
-    Real weightSum = 0.0;
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                /* reconstruct newly joined node for the solution domain */
-                if ((node[idx].gst != node[idx].did) && (sd == node[idx].did)) {
-                    /* a newly joined solution domain node */
-                    n[X] = i; n[Y] = j; n[Z] = k;
-                    p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                    weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, node[idx].did, part, node, model, Uo);
-                    Normalize(DIMUo, weightSum, Uo);
-                    Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
-                    MapConservative(model->gamma, Uo, node[idx].U[TO]);
-                    node[idx].fid = NONE; /* set domain change mark to avoid reconstruction interference */
-                }
-                /* reset interfacial state */
-                node[idx].lid = 0;
-                node[idx].gst = 0;
-                /* search neighbours to determine the current interfacial state */
-                if (sd == node[idx].did) { /* skip interfacial nodes for main domain */
-                    continue;
-                }
-                node[idx].lid = GetInterState(INTERL, k, j, i, node[idx].did, part->pathSep[0], part->path, node, part);
-                if ((0 < node[idx].lid) && (sd != node[idx].did)) { /* ghost node is a subset of interfacial node */
-                    node[idx].gst = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, node, part);
+    int *row = AssignStorage((bandN + 1) * sizeof(*row), MEMSCRATCH); /* first row of each box */
+    const int rowN = SetBoxRow(bandN, band, row);
+    /*
+     * Reconstruct newly joined nodes for the solution domain. Only original
+     * solution domain nodes are used as stencils and the interfacial state of
+     * these nodes is not modified in this pass, therefore, nodes can be
+     * reconstructed in any order.
+     */
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (int t = 0; t < rowN; ++t) {
+        const int b = LocateRow(t, bandN, row);
+        const int jN = band[b][Y][MAX] - band[b][Y][MIN];
+        const int k = band[b][Z][MIN] + (t - row[b]) / jN;
+        const int j = band[b][Y][MIN] + (t - row[b]) % jN;
+        for (int i = band[b][X][MIN]; i < band[b][X][MAX]; ++i) {
+            const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+            if ((field->gst[idx] == field->did[idx]) || (sd != field->did[idx])) {
+                continue;
+            }
+            /* a newly joined solution domain node */
+            const IntVec n = {i, j, k}; /* current node */
+            const RealVec p = { /* node point */
+                MapPoint(i, part->domain[X][MIN], part->d[X], part->n0[X]),
+                MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]),
+                MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z])};
+            Real U[DIMU] = {0.0};
+            Real Uo[DIMUo] = {0.0};
+            const Real weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, field->did[idx], part, field, model, Uo);
+            Normalize(DIMUo, weightSum, Uo);
+            Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
+            MapConservative(model->gamma, Uo, U);
+            ScatterU(idx, U, field->U[TO]);
+            field->fid[idx] = NONE; /* set domain change mark to avoid reconstruction interference */
+        }
+    }
+    /* determine interfacial state, which only depends on the domain field */
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < rowN; ++t) {
+        const int b = LocateRow(t, bandN, row);
+        const int jN = band[b][Y][MAX] - band[b][Y][MIN];
+        const int k = band[b][Z][MIN] + (t - row[b]) / jN;
+        const int j = band[b][Y][MIN] + (t - row[b]) % jN;
+        for (int i = band[b][X][MIN]; i < band[b][X][MAX]; ++i) {
+            const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+            /* reset interfacial state */
+            field->lid[idx] = 0;
+            field->gst[idx] = 0;
+            /* search neighbours to determine the current interfacial state */
+            if (sd == field->did[idx]) { /* skip interfacial nodes for main domain */
+                continue;
+            }
+            field->lid[idx] = GetInterState(INTERL, k, j, i, field->did[idx], part->pathSep[0], part->path, field, part);
+            if ((0 < field->lid[idx]) && (sd != field->did[idx])) { /* ghost node is a subset of interfacial node */
+                field->gst[idx] = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, field, part);
+            }
+            if ((0 < field->lid[idx]) && (0 < field->did[idx]) && (NONE == field->fid[idx])) {
+                /* link an interfacial node flagged without a test to its closest face */
+                const Polyhedron *poly = geo->poly + field->did[idx] - 1;
+                if (0 < poly->faceN) {
+                    const RealVec p = {
+                        MapPoint(i, part->domain[X][MIN], part->d[X], part->n0[X]),
+                        MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]),
+                        MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z])};
+                    PointInPolyhedron(p, poly, field->fid + idx);
                 }
             }
         }
     }
+    RetrieveStorage(row);
+    SetInterfacialList(space);
     return;
 }
 static int GetInterState(const int sid, const int k, const int j, const int i, const int did,
-        const int end, const int path[restrict][DIMS], const Node *const node, const Partition *const part)
+        const int end, const int path[restrict][DIMS], const Field *const field, const Partition *const part)
 {
     /* search around the specified node to check interfacial state */
     int idx = 0; /* linear array index math variable */
@@ -234,18 +874,18 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
         kh = k + path[n][Z];
         jh = j + path[n][Y];
         ih = i + path[n][X];
-        if (!InPartBox(kh, jh, ih, part->ns[PIN])) {
+        if (!InPartBox(kh, jh, ih, part->ns[PEX])) {
             continue;
         }
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
         switch (sid) {
             case INTERL:
-                if (did != node[idx].did) { /* a heterogeneous node on the path */
+                if (did != field->did[idx]) { /* a heterogeneous node on the path */
                     flag = 1;
                 }
                 break;
             case INTERG:
-                if (did == node[idx].did) { /* a computational node on the path */
+                if (did == field->did[idx]) { /* a computational node on the path */
                     flag = 1;
                 }
                 break;
@@ -263,78 +903,236 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
     return 0;
 }
 /*
- * Mo, H., Lien, F.S., Zhang, F. and Cronin, D.S., 2016. A sharp interface
- * immersed boundary method for solving flow with arbitrarily irregular and
- * changing geometry. arXiv:1602.06830.
+ * Ghost nodes and interfacial nodes of each polyhedron are gathered from
+ * its bounding box at the last node mapping in the order of a box scan, and
+ * grouped by layers and then by polyhedrons: list l * totN + n holds layer
+ * l + 1 of polyhedron n. The nodes of each list are counted first to locate
+ * them in the storage, and then recorded. Polyhedrons fill their own lists
+ * in parallel.
  */
-void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
+static void SetInterfacialList(Space *space)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
+    Interface *const ibm = &(field->ibm);
     const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    const Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
-    IntVec nI = {0}; /* image node */
-    IntVec nG = {0}; /* ghost node */
-    RealVec pG = {0.0}; /* ghost point */
-    RealVec pO = {0.0}; /* boundary point */
-    RealVec pI = {0.0}; /* image point */
-    RealVec N = {0.0}; /* normal */
-    Real UoG[DIMUo] = {0.0};
-    Real UoO[DIMUo] = {0.0};
-    Real UoI[DIMUo] = {0.0};
-    Real weightSum = 0.0;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        /* treat ghost nodes */
-        for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    const int listN = part->gl * geo->totN;
+    if (NULL == ibm->ghead) {
+        ibm->ghead = AssignStorage((listN + 1) * sizeof(*ibm->ghead), MEMFIELD);
+        ibm->ihead = AssignStorage((listN + 1) * sizeof(*ibm->ihead), MEMFIELD);
+    }
+    memset(ibm->ghead, 0, (listN + 1) * sizeof(*ibm->ghead));
+    memset(ibm->ihead, 0, (listN + 1) * sizeof(*ibm->ihead));
+    for (int pass = 0; pass < 2; ++pass) {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int n = 0; n < geo->totN; ++n) {
+            const Polyhedron *poly = geo->poly + n;
+            int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+            for (int s = 0; s < DIMS; ++s) {
+                box[s][MIN] = ConfineSpace(MapNode(poly->mbox[s][MIN], sMin[s], dd[s], n0[s]), nMin[s], nMax[s]);
+                box[s][MAX] = ConfineSpace(MapNode(poly->mbox[s][MAX], sMin[s], dd[s], n0[s]), nMin[s], nMax[s]) + 1;
+            }
             for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
                 for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                     for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        if ((r != node[idx].gst) || (n + 1 != node[idx].did)) {
+                        const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        const int lr = field->lid[idx]; /* interfacial layer */
+                        const int gr = field->gst[idx]; /* ghost layer */
+                        if ((0 >= lr) || (n + 1 != field->did[idx])) {
+                            continue;
+                        }
+                        const int l = (lr - 1) * geo->totN + n;
+                        const int g = (gr - 1) * geo->totN + n;
+                        if (0 == pass) {
+                            ++ibm->ihead[l+1];
+                            if (0 < gr) {
+                                ++ibm->ghead[g+1];
+                            }
                             continue;
                         }
-                        pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                        pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                        pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                        if (model->ibmLayer >= r) { /* immersed boundary treatment */
-                            ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                            nI[X] = MapNode(pI[X], sMin[X], dd[X], ng[X]);
-                            nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]);
-                            nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], ng[Z]);
-                            /*
-                             * When extremely strong discontinuities exist in the
-                             * domain of dependence of inverse distance weighting,
-                             * WENO's idea may be adopted to avoid discontinuous
-                             * stencils and to only use smooth stencils. However,
-                             * the algorithm will be too complex.
-                             */
-                            ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
-                            DoMethodOfImage(UoI, UoO, UoG);
-                        } else { /* inverse distance weighting */
-                            nG[X] = i; nG[Y] = j; nG[Z] = k;
-                            weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
-                            Normalize(DIMUo, weightSum, UoG);
+                        ibm->inter[ibm->ihead[l]][X] = i;
+                        ibm->inter[ibm->ihead[l]][Y] = j;
+                        ibm->inter[ibm->ihead[l]][Z] = k;
+                        ++ibm->ihead[l];
+                        if (0 < gr) {
+                            Ghost *const ghost = ibm->ghost + ibm->ghead[g];
+                            ghost->idx = idx;
+                            ghost->gid = n + 1;
+                            ghost->n[X] = i;
+                            ghost->n[Y] = j;
+                            ghost->n[Z] = k;
+                            ++ibm->ghead[g];
                         }
-                        UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoG, node[idx].U[tn]);
                     }
                 }
             }
         }
+        if (0 != pass) {
+            continue;
+        }
+        for (int l = 0; l < listN; ++l) {
+            ibm->ihead[l+1] = ibm->ihead[l+1] + ibm->ihead[l];
+            ibm->ghead[l+1] = ibm->ghead[l+1] + ibm->ghead[l];
+        }
+        ibm->interN = ibm->ihead[listN];
+        ibm->ghostN = ibm->ghead[listN];
+        if (ibm->interN > ibm->interMax) {
+            ibm->interMax = ibm->interN + ibm->interN / 2; /* spare room for moving geometries */
+            if (NULL == ibm->inter) {
+                ibm->inter = AssignStorage(ibm->interMax * sizeof(*ibm->inter), MEMFIELD);
+            } else {
+                ibm->inter = ReassignStorage(ibm->inter, ibm->interMax * sizeof(*ibm->inter));
+            }
+        }
+        if (ibm->ghostN > ibm->ghostMax) {
+            ibm->ghostMax = ibm->ghostN + ibm->ghostN / 2; /* spare room for moving geometries */
+            if (NULL == ibm->ghost) {
+                ibm->ghost = AssignStorage(ibm->ghostMax * sizeof(*ibm->ghost), MEMFIELD);
+            } else {
+                ibm->ghost = ReassignStorage(ibm->ghost, ibm->ghostMax * sizeof(*ibm->ghost));
+            }
+        }
+    }
+    /* recording has advanced each list to the start of the next one */
+    for (int l = listN; l > 0; --l) {
+        ibm->ihead[l] = ibm->ihead[l-1];
+        ibm->ghead[l] = ibm->ghead[l-1];
+    }
+    ibm->ihead[0] = 0;
+    ibm->ghead[0] = 0;
+    return;
+}
+/*
+ * Reconstruction stencils of ghost nodes only depend on the geometric
+ * field, hence they are prepared once per geometric update and the
+ * treatment of each stage only applies the cached weights. The geometric
+ * data of every ghost node is kept for surface quantities as well. The
+ * search radius of each ghost node is determined first to locate its
+ * stencil in the stencil storage, and then the stencil nodes are recorded
+ * in the order of the search.
+ */
+static void SetGhostStencil(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
+    Interface *const ibm = &(field->ibm);
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    /* geometric data and search radius */
+    for (int r = 1; r <= part->gl; ++r) {
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int m = ibm->ghead[(r-1)*geo->totN]; m < ibm->ghead[r*geo->totN]; ++m) {
+            Ghost *const ghost = ibm->ghost + m;
+            const Polyhedron *poly = geo->poly + ghost->gid - 1;
+            const RealVec pG = { /* ghost point */
+                MapPoint(ghost->n[X], sMin[X], d[X], n0[X]),
+                MapPoint(ghost->n[Y], sMin[Y], d[Y], n0[Y]),
+                MapPoint(ghost->n[Z], sMin[Z], d[Z], n0[Z])};
+            ComputeGeometricData(pG, field->fid[ghost->idx], poly, ghost->pO, ghost->p, ghost->N);
+            if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                ghost->c[X] = MapNode(ghost->p[X], sMin[X], dd[X], n0[X]);
+                ghost->c[Y] = MapNode(ghost->p[Y], sMin[Y], dd[Y], n0[Y]);
+                ghost->c[Z] = MapNode(ghost->p[Z], sMin[Z], dd[Z], n0[Z]);
+                ghost->h = SearchStencil(ghost->c, R, TYPED, 0, part, field, &(ghost->sn));
+                ghost->wO = ComputeWeight(part->tinyL, Dist2(ghost->p, ghost->pO));
+            } else { /* inverse distance weighting */
+                memcpy(ghost->p, pG, DIMS * sizeof(*pG));
+                memcpy(ghost->c, ghost->n, DIMS * sizeof(*ghost->n));
+                ghost->h = SearchStencil(ghost->c, 1, r - 1, ghost->gid, part, field, &(ghost->sn));
+            }
+        }
+    }
+    /* locate and record stencils */
+    ibm->stencilN = 0;
+    for (int m = 0; m < ibm->ghostN; ++m) {
+        ibm->ghost[m].sm = ibm->stencilN;
+        ibm->stencilN = ibm->stencilN + ibm->ghost[m].sn;
+        ibm->ghost[m].sn = ibm->stencilN;
+    }
+    if (ibm->stencilN > ibm->stencilMax) {
+        ibm->stencilMax = ibm->stencilN + ibm->stencilN / 2; /* spare room for moving geometries */
+        if (NULL == ibm->sid) {
+            ibm->sid = AssignStorage(ibm->stencilMax * sizeof(*ibm->sid), MEMFIELD);
+            ibm->sw = AssignStorage(ibm->stencilMax * sizeof(*ibm->sw), MEMFIELD);
+        } else {
+            ibm->sid = ReassignStorage(ibm->sid, ibm->stencilMax * sizeof(*ibm->sid));
+            ibm->sw = ReassignStorage(ibm->sw, ibm->stencilMax * sizeof(*ibm->sw));
+        }
+    }
+    for (int r = 1; r <= part->gl; ++r) {
+        const int type = (model->ibmLayer >= r) ? TYPED : r - 1;
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int m = ibm->ghead[(r-1)*geo->totN]; m < ibm->ghead[r*geo->totN]; ++m) {
+            const Ghost *ghost = ibm->ghost + m;
+            const int did = (TYPED == type) ? 0 : ghost->gid;
+            ScanStencil(ghost->c, ghost->p, ghost->h, type, did, part, field,
+                    ibm->sid + ghost->sm, ibm->sw + ghost->sm);
+        }
+    }
+    return;
+}
+/*
+ * Mo, H., Lien, F.S., Zhang, F. and Cronin, D.S., 2016. A sharp interface
+ * immersed boundary method for solving flow with arbitrarily irregular and
+ * changing geometry. arXiv:1602.06830.
+ */
+void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
+    const Interface *const ibm = &(field->ibm);
+    /*
+     * Treat ghost nodes layer by layer. Ghost nodes in the same layer
+     * only use solution domain nodes or ghost nodes of inner layers as
+     * stencils, therefore, they are treated in parallel. Ghost nodes of
+     * different polyhedrons never serve as stencils for each other, hence
+     * a layer is completed for all polyhedrons and then sent to neighbouring
+     * partitions before treating the next layer.
+     */
+    for (int r = 1; r <= part->gl; ++r) {
+        const int ghostM = ibm->ghead[(r-1)*geo->totN];
+        const int ghostN = ibm->ghead[r*geo->totN];
+        StartKernel(RFIBM);
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int m = ghostM; m < ghostN; ++m) {
+            const Ghost *ghost = ibm->ghost + m;
+            const Polyhedron *poly = geo->poly + ghost->gid - 1;
+            Real UG[DIMU] = {0.0};
+            Real UoG[DIMUo] = {0.0};
+            Real UoO[DIMUo] = {0.0};
+            Real UoI[DIMUo] = {0.0};
+            if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                /*
+                 * When extremely strong discontinuities exist in the
+                 * domain of dependence of inverse distance weighting,
+                 * WENO's idea may be adopted to avoid discontinuous
+                 * stencils and to only use smooth stencils. However,
+                 * the algorithm will be too complex.
+                 */
+                ReconstructFlow(tn, ghost, ibm, poly, field, model, UoO, UoI);
+                DoMethodOfImage(UoI, UoO, UoG);
+            } else { /* inverse distance weighting */
+                const Real weightSum = WeightStencil(tn, ghost, ibm, field, model, UoG);
+                Normalize(DIMUo, weightSum, UoG);
+            }
+            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
+            MapConservative(model->gamma, UoG, UG);
+            ScatterU(ghost->idx, UG, field->U[tn]);
+        }
+        StopKernel(RFIBM);
+        CountIbmCost(ghostN - ghostM, (ghostM < ghostN) ? ibm->ghost[ghostN-1].sn - ibm->ghost[ghostM].sm : 0);
+        if (0 != geo->totN) {
+            ExchangeFieldData(tn, space);
+        }
     }
     return;
 }
@@ -354,15 +1152,16 @@ void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real Uo
     UoG[5] = UoI[5];
     return;
 }
-static void ReconstructFlow(const int tn, const int n[restrict], const Real p[restrict],
-        const int h, const int type, const int did, const Polyhedron *poly, const Partition *const part,
-        const Node *const node, const Model *model, const Real pO[restrict], const Real N[restrict],
+static void ReconstructFlow(const int tn, const Ghost *ghost, const Interface *ibm,
+        const Polyhedron *poly, const Field *const field, const Model *model,
         Real UoO[restrict], Real Uo[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
+    const Real *pO = ghost->pO;
+    const Real *N = ghost->N;
     /* pre-estimate step */
-    Real weightSum = InverseDistanceWeighting(tn, n, p, h, type, did, part, node, model, Uo);
+    Real weightSum = WeightStencil(tn, ghost, ibm, field, model, Uo);
     const Real weight = one / weightSum;
     /* physical boundary condition enforcement step */
     RealVec Vs = {zero}; /* general motion of boundary point */
@@ -405,19 +1204,34 @@ static void ReconstructFlow(const int tn, const int n[restrict], const Real p[re
         UoO[5] = poly->T;
     }
     /* correction step by adding the boundary point as a stencil */
-    ApplyWeighting(UoO, part->tinyL, Dist2(p, pO), &weightSum, Uo);
+    ApplyWeighting(UoO, ghost->wO, &weightSum, Uo);
     /* Normalize the weighted values */
     Normalize(DIMUo, weightSum, Uo);
     return;
 }
+static Real WeightStencil(const int tn, const Ghost *ghost, const Interface *ibm,
+        const Field *const field, const Model *model, Real Uo[restrict])
+{
+    Real Uh[DIMU] = {0.0}; /* conservative at stencil node */
+    Real Uoh[DIMUo] = {0.0}; /* primitive at stencil node */
+    Real weightSum = 0.0;
+    memset(Uo, 0, DIMUo * sizeof(*Uo));
+    for (int m = ghost->sm; m < ghost->sn; ++m) {
+        GatherU(ibm->sid[m], field->U[tn], Uh);
+        MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
+        ApplyWeighting(Uoh, ibm->sw[m], &weightSum, Uo);
+    }
+    return weightSum;
+}
 static Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict],
         const int h, const int type, const int did, const Partition *const part,
-        const Node *const node, const Model *model, Real Uo[restrict])
+        const Field *const field, const Model *model, Real Uo[restrict])
 {
     int idx = 0; /* linear array index math variable */
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    Real Uh[DIMU] = {0.0}; /* conservative at neighbouring node */
     Real Uoh[DIMUo] = {0.0}; /* primitive at neighbouring node */
     RealVec ph = {0.0}; /* neighbouring point */
     IntVec nh = {0}; /* neighbouring node */
@@ -437,48 +1251,100 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     nh[X] = n[X] + ih;
                     nh[Y] = n[Y] + jh;
                     nh[Z] = n[Z] + kh;
-                    if (!InPartBox(nh[Z], nh[Y], nh[X], part->ns[PIN])) {
+                    if (!InPartBox(nh[Z], nh[Y], nh[X], part->ns[PEX])) {
                         continue;
                     }
                     idx = IndexNode(nh[Z], nh[Y], nh[X], part->n[Y], part->n[X]);
                     /* be aware of the validity of ih = jh = kh = 0 */
-                    if (did != node[idx].did) {
-                        continue; /* skip node not in target domain */
-                    }
-                    switch (type) {
-                        case TYPED: /* use node in target domain */
-                            break;
-                        case TYPEF: /* use original node in target domain to avoid priority */
-                            if ((did != node[idx].gst) || (0 > node[idx].fid)) {
-                                continue; /* skip changed node either reconstructed or not */
-                            }
-                            break;
-                        default: /* use node in target domain layer */
-                            if (type != node[idx].gst) {
-                                continue;
-                            }
-                            break;
+                    if (!InStencil(idx, type, did, field)) {
+                        continue;
                     }
                     ++tally;
-                    ph[X] = MapPoint(nh[X], sMin[X], d[X], ng[X]);
-                    ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], ng[Y]);
-                    ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], ng[Z]);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[tn], Uoh);
-                    ApplyWeighting(Uoh, part->tinyL, Dist2(p, ph), &weightSum, Uo);
+                    ph[X] = MapPoint(nh[X], sMin[X], d[X], n0[X]);
+                    ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], n0[Y]);
+                    ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], n0[Z]);
+                    GatherU(idx, field->U[tn], Uh);
+                    MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
+                    ApplyWeighting(Uoh, ComputeWeight(part->tinyL, Dist2(p, ph)), &weightSum, Uo);
                 }
             }
         }
     }
     return weightSum;
 }
-static void ApplyWeighting(const Real Uoh[restrict], const Real tiny, Real weight,
-        Real weightSum[restrict], Real Uo[restrict])
+/*
+ * The search radius grows from h until the cube of the radius around the
+ * center node contains stencil nodes, as in inverse distance weighting.
+ */
+static int SearchStencil(const int n[restrict], const int h, const int type, const int did,
+        const Partition *const part, const Field *const field, int *tally)
+{
+    int r = h;
+    *tally = ScanStencil(n, NULL, r, type, did, part, field, NULL, NULL);
+    while (0 == *tally) {
+        ++r;
+        *tally = ScanStencil(n, NULL, r, type, did, part, field, NULL, NULL);
+    }
+    return r;
+}
+static int ScanStencil(const int n[restrict], const Real p[restrict], const int r, const int type,
+        const int did, const Partition *const part, const Field *const field,
+        int sid[restrict], Real sw[restrict])
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    int tally = 0;
+    for (int kh = n[Z] - r; kh <= n[Z] + r; ++kh) {
+        for (int jh = n[Y] - r; jh <= n[Y] + r; ++jh) {
+            for (int ih = n[X] - r; ih <= n[X] + r; ++ih) {
+                if (!InPartBox(kh, jh, ih, part->ns[PEX])) {
+                    continue;
+                }
+                const int idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
+                if (!InStencil(idx, type, did, field)) {
+                    continue;
+                }
+                if (NULL != sid) {
+                    const RealVec ph = {
+                        MapPoint(ih, sMin[X], d[X], n0[X]),
+                        MapPoint(jh, sMin[Y], d[Y], n0[Y]),
+                        MapPoint(kh, sMin[Z], d[Z], n0[Z])};
+                    sid[tally] = idx;
+                    sw[tally] = ComputeWeight(part->tinyL, Dist2(p, ph));
+                }
+                ++tally;
+            }
+        }
+    }
+    return tally;
+}
+static int InStencil(const int idx, const int type, const int did, const Field *const field)
+{
+    if (did != field->did[idx]) {
+        return 0; /* skip node not in target domain */
+    }
+    switch (type) {
+        case TYPED: /* use node in target domain */
+            return 1;
+        case TYPEF: /* use original node in target domain to avoid priority */
+            /* skip changed node either reconstructed or not */
+            return (did == field->gst[idx]) && (0 <= field->fid[idx]);
+        default: /* use node in target domain layer */
+            return type == field->gst[idx];
+    }
+}
+static Real ComputeWeight(const Real tiny, Real weight)
 {
     const Real one = 1.0;
     if (tiny > weight) { /* avoid overflow of too small weight */
         weight = tiny;
     }
-    weight = one / weight; /* compute weight */
+    return one / weight; /* compute weight */
+}
+static void ApplyWeighting(const Real Uoh[restrict], const Real weight,
+        Real weightSum[restrict], Real Uo[restrict])
+{
     for (int n = 0; n < DIMUo; ++n) {
         Uo[n] = Uo[n] + Uoh[n] * weight;
     }
@@ -486,4 +1352,3 @@ static void ApplyWeighting(const Real Uoh[restrict], const Real tiny, Real weigh
     return;
 }
 /* a good practice: end file with a newline */
-
@@ -30,8 +30,10 @@ static void InitializeFieldData(Space *, const Model *);
 static void ApplyInitializer(const int, const Real [restrict],
         Real [restrict], const Partition *const, const Model *);
 static void InitializeGeometryData(Geometry *const);
+static void InstantiatePolyhedron(String [restrict], Real [restrict][DIMS][DIMS], Geometry *const);
 static void WritePolyMassProperty(const Geometry *const);
 static void IdentifyGeometryState(Geometry *const);
+static void InitializeDistanceGrid(const Partition *const, Geometry *const);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -43,7 +45,12 @@ void InitializeComputeDomain(Time *time, Space *space, const Model *model)
         ReadData(PROSD, time, space, model);
     }
     ComputeGeometryParameters(space->part.collapse, &(space->geo));
-    WritePolyMassProperty(&(space->geo));
+    if (0 != model->distGrid) {
+        InitializeDistanceGrid(&(space->part), &(space->geo));
+    }
+    if (0 == space->part.rank) { /* only the root process writes shared files */
+        WritePolyMassProperty(&(space->geo));
+    }
     ComputeGeometricField(space, model);
     TreatBoundary(TO, space, model);
     IdentifyGeometryState(&(space->geo));
@@ -68,33 +75,40 @@ static void InitializeSpaceData(Space *space, const Model *model)
 static void InitializeFieldData(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    RealVec pc = {0.0}; /* coordinates of current node */
-    int idx = 0; /* linear array index math variable */
+    Field *const field = &(space->field);
+    for (int tn = 0; tn < model->levelN; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            memset(field->U[tn][n], 1, field->stride * sizeof(*field->U[tn][n]));
+        }
+    }
+    #pragma omp parallel for collapse(3) schedule(static)
     for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
         for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
             for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                node[idx].did = NONE;
-                node[idx].fid = NONE;
-                node[idx].lid = NONE;
-                node[idx].gst = NONE;
-                memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                field->did[idx] = NONE;
+                field->fid[idx] = NONE;
+                field->lid[idx] = NONE;
+                field->gst[idx] = NONE;
                 if (!InPartBox(k, j, i, part->ns[PIN])) {
                     continue;
                 }
                 /* geometric field initializer */
-                node[idx].did = 0;
-                node[idx].fid = 0;
-                node[idx].lid = 0;
-                node[idx].gst = 0;
+                field->did[idx] = 0;
+                field->fid[idx] = 0;
+                field->lid[idx] = 0;
+                field->gst[idx] = 0;
                 /* data field initializer */
-                pc[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                pc[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                pc[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                const RealVec pc = { /* coordinates of current node */
+                    MapPoint(i, part->domain[X][MIN], part->d[X], part->n0[X]),
+                    MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]),
+                    MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z])};
+                Real U[DIMU] = {0.0};
+                GatherU(idx, field->U[TO], U);
                 for (int n = 0; n < part->nIC; ++n) {
-                    ApplyInitializer(n, pc, node[idx].U[TO], part, model);
+                    ApplyInitializer(n, pc, U, part, model);
                 }
+                ScatterU(idx, U, field->U[TO]);
             }
         }
     }
@@ -160,13 +174,24 @@ static void ApplyInitializer(const int n, const Real pc[restrict], Real U[restri
     }
     return;
 }
+/*
+ * Meshes are loaded after the whole file is read, as a mesh is identified
+ * by its file and the scale of its instances.
+ */
 static void InitializeGeometryData(Geometry *const geo)
 {
     FILE *fp = Fopen("artracfd.geo", "r");
     const char *fmtI = ParseFormat("%lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg");
+    const int stlN = geo->totN - geo->sphN;
+    String *name = AssignStorage(stlN * sizeof(*name), MEMSCRATCH); /* file name */
+    Real (*trans)[DIMS][DIMS] = AssignStorage(stlN * sizeof(*trans), MEMSCRATCH); /* scale, angle, offset */
+    for (int n = 0; n < stlN; ++n) {
+        trans[n][0][X] = 1.0;
+        trans[n][0][Y] = 1.0;
+        trans[n][0][Z] = 1.0;
+    }
     /* read and process file line by line */
     String str = {'\0'}; /* store the current read line */
-    String fname = {'\0'}; /* store the file name */
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "sphere state begin", sizeof str)) {
@@ -174,10 +199,8 @@ static void InitializeGeometryData(Geometry *const geo)
             continue;
         }
         if (0 == strncmp(str, "polyhedron geometry begin", sizeof str)) {
-            for (int n = geo->sphN; n < geo->totN; ++n) {
-                Sread(fp, 1, "%s", fname);
-                ReadStlFile(fname, geo->poly + n);
-                ConvertPolyhedron(geo->poly + n);
+            for (int n = 0; n < stlN; ++n) {
+                Sread(fp, 1, "%s", name[n]);
             }
             continue;
         }
@@ -186,25 +209,104 @@ static void InitializeGeometryData(Geometry *const geo)
             continue;
         }
         if (0 == strncmp(str, "polyhedron transform begin", sizeof str)) {
-            const Real one = 1.0;
-            const Real zero = 0.0;
-            RealVec scale = {zero};
-            RealVec angle = {zero};
-            RealVec offset = {zero};
-            for (int n = geo->sphN; n < geo->totN; ++n) {
-                Sread(fp, 9, fmtI, scale + X, scale + Y, scale + Z,
-                        angle + X, angle + Y, angle + Z, offset + X, offset + Y, offset + Z);
-                if ((one == scale[X]) && (one == scale[Y]) && (one == scale[Z]) &&
-                        (zero == angle[X]) && (zero == angle[Y]) && (zero == angle[Z]) &&
-                        (zero == offset[X]) && (zero == offset[Y]) && (zero == offset[Z])) {
-                    continue;
-                }
-                TransformPolyhedron(geo->poly[n].O, scale, angle, offset, geo->poly + n);
+            /* scale, Euler angles about x, y, z in turn, and translation */
+            for (int n = 0; n < stlN; ++n) {
+                Sread(fp, 9, fmtI, trans[n][0] + X, trans[n][0] + Y, trans[n][0] + Z,
+                        trans[n][1] + X, trans[n][1] + Y, trans[n][1] + Z,
+                        trans[n][2] + X, trans[n][2] + Y, trans[n][2] + Z);
             }
             continue;
         }
     }
     fclose(fp);
+    InstantiatePolyhedron(name, trans, geo);
+    RetrieveStorage(trans);
+    RetrieveStorage(name);
+    return;
+}
+/*
+ * Polyhedrons of the same file and scale are instances of one mesh, which
+ * is loaded by the first of them and shared by the others.
+ */
+static void InstantiatePolyhedron(String name[restrict], Real trans[restrict][DIMS][DIMS],
+        Geometry *const geo)
+{
+    const Real one = 1.0;
+    for (int n = geo->sphN, l = 0; n < geo->totN; ++n, ++l) {
+        Polyhedron *const poly = geo->poly + n;
+        poly->mesh = n;
+        for (int m = geo->sphN, k = 0; m < n; ++m, ++k) {
+            if ((m == geo->poly[m].mesh) && (0 == strncmp(name[k], name[l], sizeof(String))) &&
+                    (trans[k][0][X] == trans[l][0][X]) && (trans[k][0][Y] == trans[l][0][Y]) &&
+                    (trans[k][0][Z] == trans[l][0][Z])) {
+                SharePolyhedron(geo->poly + m, poly);
+                break;
+            }
+        }
+        if (n == poly->mesh) {
+            ReadStlFile(name[l], poly);
+            ConvertPolyhedron(poly);
+            if ((one != trans[l][0][X]) || (one != trans[l][0][Y]) || (one != trans[l][0][Z])) {
+                ScalePolyhedron(trans[l][0], poly);
+            }
+        }
+        PlacePolyhedron(poly->O, trans[l][0], trans[l][1], trans[l][2], poly);
+    }
+    return;
+}
+/*
+ * The distance grid takes the smallest mesh size of the fluid. Queries are
+ * exact within the interfacial layers and one more layer that a node can
+ * enter after a step, plus the cell diagonal of the grid, so that closest
+ * faces used by the immersed boundary treatment are not approximated.
+ * Collapsed dimensions, whose mesh size is the domain extent, take part in
+ * neither the spacing nor the band.
+ */
+static void InitializeDistanceGrid(const Partition *const part, Geometry *const geo)
+{
+    IntVec flat = {0}; /* collapsed dimensions */
+    switch (part->collapse) {
+        case COLLAPSEX:
+            flat[X] = 1;
+            break;
+        case COLLAPSEY:
+            flat[Y] = 1;
+            break;
+        case COLLAPSEZ:
+            flat[Z] = 1;
+            break;
+        case COLLAPSEXY:
+            flat[X] = 1;
+            flat[Y] = 1;
+            break;
+        case COLLAPSEXZ:
+            flat[X] = 1;
+            flat[Z] = 1;
+            break;
+        case COLLAPSEYZ:
+            flat[Y] = 1;
+            flat[Z] = 1;
+            break;
+        default:
+            break;
+    }
+    Real h = 0.0;
+    Real dMax = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        if (0 != flat[s]) {
+            continue;
+        }
+        h = ((0.0 == h) || (h > part->d[s])) ? part->d[s] : h;
+        dMax = MaxReal(dMax, part->d[s]);
+    }
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        Polyhedron *const poly = geo->poly + n;
+        if (n == poly->mesh) {
+            ComputeDistanceGrid(h, (part->gl + 2) * dMax + 2.0 * h, flat, poly);
+        } else {
+            ShareDistanceGrid(geo->poly + poly->mesh, poly);
+        }
+    }
     return;
 }
 static void WritePolyMassProperty(const Geometry *const geo)
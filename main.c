@@ -18,6 +18,7 @@
 #include "preprocess.h"
 #include "solve.h"
 #include "postprocess.h"
+#include "numerical_test.h"
 /****************************************************************************
  * The Main Function
  ****************************************************************************/
@@ -26,7 +27,9 @@ int main(int argc, char *argv[])
     /* declare and initialize variables */
     Control control = {
         .runMode = 'i',
-        .proc = {0}};
+        .proc = {0},
+        .budget = 0.0,
+        .reference = NULL};
     Time time = {0};
     Space space = {0};
     Model model = {0};
@@ -34,6 +37,9 @@ int main(int argc, char *argv[])
     EnterProgram(argc, argv, &control, &space);
     Preprocess(&time, &space, &model);
     Solve(&time, &space, &model);
+    if (NULL != control.reference) {
+        ComputeSolutionDeviation(control.reference, &space, &model);
+    }
     Postprocess(&time, &space, &model);
     exit(EXIT_SUCCESS);
 }
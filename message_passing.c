@@ -0,0 +1,284 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "message_passing.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#ifdef ARTRACFD_MPI
+#include <mpi.h> /* distributed memory message passing */
+#endif
+#include "cfd_commons.h"
+#include "commons.h"
+#ifdef ARTRACFD_MPI
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ExchangeHalo(const int, void *const [], const size_t, const Partition *const);
+static void PackHalo(const int, void *const [], const size_t, int [restrict][LIMIT],
+        char *, const Partition *const);
+static void UnpackHalo(const int, void *const [], const size_t, int [restrict][LIMIT],
+        const char *, const Partition *const);
+static void ReserveBuffer(const size_t);
+static int MapRank(const int);
+static MPI_Datatype RealType(void);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static char *sendBuf = NULL; /* send buffer of halo exchange */
+static char *recvBuf = NULL; /* receive buffer of halo exchange */
+static size_t bufSize = 0; /* size of each buffer in bytes */
+#endif
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void InitializeMessagePassing(Partition *part)
+{
+#ifdef ARTRACFD_MPI
+    int flag = 0;
+    MPI_Initialized(&flag);
+    if (!flag) {
+        MPI_Init(NULL, NULL);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &(part->rank));
+    MPI_Comm_size(MPI_COMM_WORLD, &(part->rankN));
+    if (0 != part->rank) { /* only the root process reports information */
+        if (NULL == freopen("/dev/null", "w", stdout)) {
+            ShowWarning("standard output of process %d not silenced", part->rank);
+        }
+    }
+    if (part->procN != part->rankN) {
+        ShowError("processors %d*%d*%d mismatch %d processes",
+                part->proc[X], part->proc[Y], part->proc[Z], part->rankN);
+    }
+#else
+    part->rank = 0;
+    part->rankN = 1;
+    ShowWarning("mpi not enabled by compiler, processors ignored");
+#endif
+    return;
+}
+void FinalizeMessagePassing(void)
+{
+#ifdef ARTRACFD_MPI
+    int flag = 0;
+    MPI_Initialized(&flag);
+    if (!flag) {
+        return;
+    }
+    RetrieveStorage(sendBuf);
+    RetrieveStorage(recvBuf);
+    sendBuf = NULL;
+    recvBuf = NULL;
+    bufSize = 0;
+    MPI_Finalize();
+#endif
+    return;
+}
+void ExchangeFieldData(const int tn, Space *space)
+{
+    const Partition *const part = &(space->part);
+    if (1 == part->rankN) {
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    void *const var[DIMU] = {
+        space->field.U[tn][0],
+        space->field.U[tn][1],
+        space->field.U[tn][2],
+        space->field.U[tn][3],
+        space->field.U[tn][4]};
+    ExchangeHalo(DIMU, var, sizeof(FdReal), part);
+#else
+    (void)tn; /* only used by message passing */
+#endif
+    return;
+}
+void ExchangeGeometricField(Space *space)
+{
+    const Partition *const part = &(space->part);
+    if (1 == part->rankN) {
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    void *const var[4] = {
+        space->field.did,
+        space->field.fid,
+        space->field.lid,
+        space->field.gst};
+    ExchangeHalo(4, var, sizeof(int), part);
+#endif
+    return;
+}
+void ReduceMax(const int n, Real data[], const Partition *const part)
+{
+    if (1 == part->rankN) {
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    MPI_Allreduce(MPI_IN_PLACE, data, n, RealType(), MPI_MAX, MPI_COMM_WORLD);
+#else
+    (void)n; /* only used by message passing */
+    (void)data;
+#endif
+    return;
+}
+void ReduceSum(const int n, Real data[], const Partition *const part)
+{
+    if (1 == part->rankN) {
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    MPI_Allreduce(MPI_IN_PLACE, data, n, RealType(), MPI_SUM, MPI_COMM_WORLD);
+#else
+    (void)n; /* only used by message passing */
+    (void)data;
+#endif
+    return;
+}
+void GatherInt(const int n, const int send[], int recv[], const Partition *const part)
+{
+    if (1 == part->rankN) {
+        memcpy(recv, send, n * sizeof(*send));
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    MPI_Gather(send, n, MPI_INT, recv, n, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    return;
+}
+void SynchronizeProcess(const Partition *const part)
+{
+    if (1 == part->rankN) {
+        return;
+    }
+#ifdef ARTRACFD_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    return;
+}
+#ifdef ARTRACFD_MPI
+/*
+ * Each dimension is exchanged in two sweeps: send the lower layers of the
+ * block to the lower neighbour while receiving the upper halo from the
+ * upper neighbour, then the reverse. The entire extent of the other
+ * dimensions is transferred, therefore, after exchanging x, y, z in
+ * sequence, edge and corner halos carry data of diagonal neighbours.
+ * For a decomposed periodic dimension, the first and the last node layers
+ * of the entire domain coincide, hence the layers sent across the periodic
+ * boundary are shifted by one node to skip the duplicated layer.
+ */
+static void ExchangeHalo(const int varN, void *const var[], const size_t size, const Partition *const part)
+{
+    int box[DIMS][LIMIT] = {{0}}; /* range box of halo layers */
+    for (int s = 0, p = PWB; s < DIMS; ++s, p = p + 2) {
+        if ((NONE == part->nbr[p]) && (NONE == part->nbr[p+1])) {
+            continue;
+        }
+        for (int r = 0; r < DIMS; ++r) {
+            box[r][MIN] = part->ns[PAL][r][MIN];
+            box[r][MAX] = part->ns[PAL][r][MAX];
+        }
+        box[s][MIN] = 0;
+        box[s][MAX] = part->ng[s];
+        const int count = varN * size * (box[X][MAX] - box[X][MIN]) *
+            (box[Y][MAX] - box[Y][MIN]) * (box[Z][MAX] - box[Z][MIN]);
+        ReserveBuffer(count);
+        /* send to the lower neighbour, receive from the upper neighbour */
+        box[s][MIN] = part->ng[s] + (0 == part->pid[s]);
+        box[s][MAX] = box[s][MIN] + part->ng[s];
+        if (NONE != part->nbr[p]) {
+            PackHalo(varN, var, size, box, sendBuf, part);
+        }
+        MPI_Sendrecv(sendBuf, count, MPI_BYTE, MapRank(part->nbr[p]), 0,
+                recvBuf, count, MPI_BYTE, MapRank(part->nbr[p+1]), 0,
+                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (NONE != part->nbr[p+1]) {
+            box[s][MIN] = part->n[s] - part->ng[s];
+            box[s][MAX] = part->n[s];
+            UnpackHalo(varN, var, size, box, recvBuf, part);
+        }
+        /* send to the upper neighbour, receive from the lower neighbour */
+        box[s][MAX] = part->n[s] - part->ng[s] - (part->proc[s] - 1 == part->pid[s]);
+        box[s][MIN] = box[s][MAX] - part->ng[s];
+        if (NONE != part->nbr[p+1]) {
+            PackHalo(varN, var, size, box, sendBuf, part);
+        }
+        MPI_Sendrecv(sendBuf, count, MPI_BYTE, MapRank(part->nbr[p+1]), 1,
+                recvBuf, count, MPI_BYTE, MapRank(part->nbr[p]), 1,
+                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (NONE != part->nbr[p]) {
+            box[s][MIN] = 0;
+            box[s][MAX] = part->ng[s];
+            UnpackHalo(varN, var, size, box, recvBuf, part);
+        }
+    }
+    return;
+}
+static void PackHalo(const int varN, void *const var[], const size_t size, int box[restrict][LIMIT],
+        char *buf, const Partition *const part)
+{
+    const size_t len = (box[X][MAX] - box[X][MIN]) * size; /* contiguous segment along x */
+    for (int n = 0; n < varN; ++n) {
+        const char *const data = var[n];
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                memcpy(buf, data + IndexNode(k, j, box[X][MIN], part->n[Y], part->n[X]) * size, len);
+                buf = buf + len;
+            }
+        }
+    }
+    return;
+}
+static void UnpackHalo(const int varN, void *const var[], const size_t size, int box[restrict][LIMIT],
+        const char *buf, const Partition *const part)
+{
+    const size_t len = (box[X][MAX] - box[X][MIN]) * size; /* contiguous segment along x */
+    for (int n = 0; n < varN; ++n) {
+        char *const data = var[n];
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                memcpy(data + IndexNode(k, j, box[X][MIN], part->n[Y], part->n[X]) * size, buf, len);
+                buf = buf + len;
+            }
+        }
+    }
+    return;
+}
+static void ReserveBuffer(const size_t size)
+{
+    if (bufSize >= size) {
+        return;
+    }
+    RetrieveStorage(sendBuf);
+    RetrieveStorage(recvBuf);
+    sendBuf = AssignStorage(size, MEMMESSAGE);
+    recvBuf = AssignStorage(size, MEMMESSAGE);
+    bufSize = size;
+    return;
+}
+static int MapRank(const int rank)
+{
+    if (NONE == rank) {
+        return MPI_PROC_NULL;
+    }
+    return rank;
+}
+static MPI_Datatype RealType(void)
+{
+    if (sizeof(double) == sizeof(Real)) {
+        return MPI_DOUBLE;
+    }
+    return MPI_FLOAT;
+}
+#endif
+/* a good practice: end file with a newline */
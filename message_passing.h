@@ -0,0 +1,63 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_MESSAGE_PASSING_H_ /* if undefined */
+#define ARTRACFD_MESSAGE_PASSING_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Message passing environment
+ *
+ * Function
+ *      Start the message passing environment, identify the rank of
+ *      current process, and silence the standard output of all
+ *      processes except the root process. The environment is only
+ *      available when compiled with ARTRACFD_MPI defined.
+ *      Finalize the environment before exit.
+ */
+extern void InitializeMessagePassing(Partition *);
+extern void FinalizeMessagePassing(void);
+/*
+ * Halo exchange
+ *
+ * Function
+ *      Fill the halo layers of current partition with the nodes of
+ *      neighbouring partitions, one dimension after another over the
+ *      entire tangential extent so that edge and corner halos are also
+ *      filled. Field data exchange a time level of conservative variables,
+ *      geometric field exchange all node identifiers.
+ */
+extern void ExchangeFieldData(const int, Space *);
+extern void ExchangeGeometricField(Space *);
+/*
+ * Collective operations
+ *
+ * Function
+ *      Reduce data in place by maximum or summation over all processes.
+ *      Gather data of each process into the root process in rank order.
+ *      Synchronize all processes.
+ */
+extern void ReduceMax(const int, Real [], const Partition *const);
+extern void ReduceSum(const int, Real [], const Partition *const);
+extern void GatherInt(const int, const int [], int [], const Partition *const);
+extern void SynchronizeProcess(const Partition *const);
+#endif
+/* a good practice: end file with a newline */
@@ -15,6 +15,7 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
 #include "boundary_treatment.h"
 #include "cfd_commons.h"
 #include "commons.h"
@@ -24,6 +25,7 @@
 typedef enum {
     TCN = 2, /* position index of center node in stencil */
     TTN = 5, /* number of nodes in a stencil */
+    TVN = 5, /* number of compared variables: rho, u, v, w, p */
 } TestConst;
 /****************************************************************************
  * Function definitions
@@ -32,9 +34,9 @@ void ComputeSolutionError(Space *space)
 {
     FILE *fp = Fopen("solution_error.csv", "w");
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict Us = NULL; /* numerical solution */
-    Real *restrict Ue = NULL; /* exact solution */
+    Field *const field = &(space->field);
+    Real Us[DIMU] = {0.0}; /* numerical solution */
+    Real Ue[DIMU] = {0.0}; /* exact solution */
     int idx = 0; /* linear array index math variable */
     const int meshN = MaxInt(part->m[X], MaxInt(part->m[Y], part->m[Z]));
     Real norm[3] = {0.0}; /* Lp norms */
@@ -44,8 +46,8 @@ void ComputeSolutionError(Space *space)
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                Us = node[idx].U[TO];
-                Ue = node[idx].U[TN];
+                GatherU(idx, field->U[TO], Us);
+                GatherU(idx, field->U[TN], Ue);
                 err = fabs(Us[0] - Ue[0]);
                 norm[0] = MaxReal(norm[0], err);
                 norm[1] = norm[1] + err;
@@ -61,6 +63,74 @@ void ComputeSolutionError(Space *space)
     fclose(fp);
     return;
 }
+void ComputeSolutionDeviation(const char *fname, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    if (1 < part->rankN) {
+        ShowError("solution deviation requires a single partition");
+    }
+    const Field *const field = &(space->field);
+    Real U[DIMU] = {0.0}; /* numerical solution */
+    Real Uo[DIMUo] = {0.0}; /* primitive variables */
+    int idx = 0; /* linear array index math variable */
+    FILE *fp = fopen(fname, "r");
+    if (NULL == fp) { /* no reference yet, the current solution becomes one */
+        fp = Fopen(fname, "w");
+        fprintf(fp, "# did, rho, u, v, w, p\n");
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    GatherU(idx, field->U[TO], U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uo);
+                    fprintf(fp, "%d, %.17g, %.17g, %.17g, %.17g, %.17g\n", field->did[idx],
+                            Uo[0], Uo[1], Uo[2], Uo[3], Uo[4]);
+                }
+            }
+        }
+        fclose(fp);
+        ShowInfo("  reference solution written to %s\n", fname);
+        return;
+    }
+    const char *fmtI = ParseFormat("%d, %lg, %lg, %lg, %lg, %lg");
+    int did = 0; /* reference domain id */
+    Real Ue[TVN] = {0.0}; /* reference solution */
+    Real norm[TVN][4] = {{0.0}}; /* max error, max reference, error square, reference square */
+    Real err = 0.0; /* solution deviation */
+    int N = 0; /* number of compared nodes */
+    Sread(fp, 0, "");
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                Fscanf(fp, 1 + TVN, fmtI, &did, Ue, Ue + 1, Ue + 2, Ue + 3, Ue + 4);
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if ((0 != did) || (0 != field->did[idx])) { /* fluid nodes of both */
+                    continue;
+                }
+                GatherU(idx, field->U[TO], U);
+                MapPrimitive(model->gamma, model->gasR, U, Uo);
+                for (int s = 0; s < TVN; ++s) {
+                    err = fabs(Uo[s] - Ue[s]);
+                    norm[s][0] = MaxReal(norm[s][0], err);
+                    norm[s][1] = MaxReal(norm[s][1], fabs(Ue[s]));
+                    norm[s][2] = norm[s][2] + err * err;
+                    norm[s][3] = norm[s][3] + Ue[s] * Ue[s];
+                }
+                ++N;
+            }
+        }
+    }
+    fclose(fp);
+    fp = Fopen("solution_deviation.csv", "w");
+    fprintf(fp, "# nodes, variable, max relative deviation, relative l2 deviation\n");
+    const char *name[TVN] = {"rho", "u", "v", "w", "p"};
+    for (int s = 0; s < TVN; ++s) {
+        fprintf(fp, "%d, %s, %.6g, %.6g\n", N, name[s],
+                norm[s][0] / MaxReal(norm[s][1], FLT_MIN), sqrt(norm[s][2] / MaxReal(norm[s][3], FLT_MIN)));
+    }
+    fclose(fp);
+    return;
+}
 void ComputeSolutionFunctional(const Time *time, Space *space, const Model *model)
 {
     FILE *fp = Fopen("solution_functional.csv", "a");
@@ -68,8 +138,8 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
         fprintf(fp, "# time, kinetic energy, enstrophy \n");
     }
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL; /* numerical solution */
+    Field *const field = &(space->field);
+    Real U[DIMU] = {0.0}; /* numerical solution */
     int idx = 0; /* linear array index math variable */
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
@@ -87,7 +157,7 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
                 for (int s = 0; s < DIMS; ++s) {
                     for (int n = -TCN; n <= TCN; ++n) {
                         idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
+                        GatherU(idx, field->U[TO], U);
                         Vs[X][TCN+n] = U[1] / U[0];
                         Vs[Y][TCN+n] = U[2] / U[0];
                         Vs[Z][TCN+n] = U[3] / U[0];
@@ -97,7 +167,7 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
                     dV[Z][s] = (-Vs[Z][TCN+2] + 8.0 * Vs[Z][TCN+1] - 8.0 * Vs[Z][TCN-1] + Vs[Z][TCN-2]) / (12.0 * d[s]);
                 }
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
+                GatherU(idx, field->U[TO], U);
                 rho = U[0];
                 V[X] = U[1] / U[0];
                 V[Y] = U[2] / U[0];
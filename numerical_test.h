@@ -28,6 +28,20 @@
  */
 extern void ComputeSolutionError(Space *);
 extern void ComputeSolutionFunctional(const Time *, Space *, const Model *);
+/*
+ * Compute solution deviation from a reference
+ *
+ * Function
+ *      If the reference file does not exist, write the primitive variables
+ *      of the current solution to it in full precision. Otherwise, compare
+ *      fluid nodes against it and write, per variable, the max error over
+ *      the max reference value and the relative l2 error to
+ *      solution_deviation.csv. Running a case in the double build and then
+ *      in the mixed precision build with the same reference file measures
+ *      the effect of single precision field storage. The two runs must
+ *      reach the same final step. Only a single partition is supported.
+ */
+extern void ComputeSolutionDeviation(const char *fname, Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
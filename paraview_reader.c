@@ -63,14 +63,39 @@ static void ReadCaseFile(Time *time, PvSet *pvSet)
 }
 static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
 {
-    snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
+    const Partition *const part = &(space->part);
+    int len = 0; /* length of the composed file name */
+    if (1 < part->rankN) { /* data piece of each partition */
+        len = snprintf(pvSet->fname, sizeof(PvStr), "%s_p%d%s", pvSet->bname, part->rank, pvSet->fext);
+    } else {
+        len = snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
+    }
+    if ((int)sizeof(PvStr) <= len) {
+        ShowError("file name too long: %s", pvSet->bname);
+    }
     FILE *fp = Fopen(pvSet->fname, "r");
     PvReal data = 0.0; /* paraview scalar data */
     const char *fmtI = ParseFormat("%lg");
-    const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL;
+    Field *const field = &(space->field);
+    FdReal *const *const U = field->U[TO];
     int idx = 0; /* linear array index math variable */
+    int piece[2*DIMS] = {0}; /* piece extent */
+    /* the piece must hold exactly the iostream region of current partition */
+    Sread(fp, 0, "");
+    Sread(fp, 0, "");
+    Sread(fp, 0, "");
+    Sread(fp, 2 * DIMS, "%*s Extent=\"%d %d %d %d %d %d\"",
+            piece, piece + 1, piece + 2, piece + 3, piece + 4, piece + 5);
+    for (int s = 0; s < DIMS; ++s) {
+        if (piece[2*s+1] - piece[2*s] + 1 != part->ns[PIO][s][MAX] - part->ns[PIO][s][MIN]) {
+            ShowError("piece extent of %s mismatches the partition", pvSet->fname);
+        }
+    }
+    for (int tn = 0; tn < model->levelN; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            memset(field->U[tn][n], 1, field->stride * sizeof(*field->U[tn][n]));
+        }
+    }
     /* get rid of redundant lines */
     ReadInLine(fp, "<PointData>");
     for (int s = 0; s < pvSet->scaN; ++s) {
@@ -81,39 +106,38 @@ static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                     if (0 == s) {
                         /* geometric field initializer */
-                        node[idx].did = NONE;
-                        node[idx].fid = NONE;
-                        node[idx].lid = NONE;
-                        node[idx].gst = NONE;
-                        memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                        field->did[idx] = NONE;
+                        field->fid[idx] = NONE;
+                        field->lid[idx] = NONE;
+                        field->gst[idx] = NONE;
                         if (InPartBox(k, j, i, part->ns[PIN])) {
-                            node[idx].did = 0;
-                            node[idx].fid = 0;
-                            node[idx].lid = 0;
-                            node[idx].gst = 0;
+                            field->did[idx] = 0;
+                            field->fid[idx] = 0;
+                            field->lid[idx] = 0;
+                            field->gst[idx] = 0;
                         }
                     }
                     if (!InPartBox(k, j, i, part->ns[PIO])) {
                         continue;
                     }
                     /* data field initializer */
-                    U = node[idx].U[TO];
                     Fscanf(fp, 1, fmtI, &data);
                     switch (s) {
                         case 0: /* rho */
-                            U[0] = data;
+                            U[0][idx] = data;
                             break;
                         case 1: /* u */
-                            U[1] = U[0] * data;
+                            U[1][idx] = U[0][idx] * data;
                             break;
                         case 2: /* v */
-                            U[2] = U[0] * data;
+                            U[2][idx] = U[0][idx] * data;
                             break;
                         case 3: /* w */
-                            U[3] = U[0] * data;
+                            U[3][idx] = U[0][idx] * data;
                             break;
                         case 4: /* p */
-                            U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] +
+                            U[4][idx] = 0.5 * (U[1][idx] * U[1][idx] + U[2][idx] * U[2][idx] +
+                                U[3][idx] * U[3][idx]) / U[0][idx] +
                                 data / (model->gamma - 1.0);
                             break;
                         default:
@@ -205,8 +229,7 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 1, "%*s %*s %d", &(poly->faceN));
         Sread(fp, 0, "");
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
-        Sread(fp, 0, "");
+        poly->mesh = m; /* meshes are restored in the current frame */
         Sread(fp, 0, "");
         Sread(fp, 0, "");
         Sread(fp, 0, "");
@@ -228,11 +251,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 0, "");
         for (int n = 0; n < poly->faceN; ++n) {
             Fscanf(fp, 3, "%d %d %d", &(poly->f[n][0]), &(poly->f[n][1]), &(poly->f[n][2]));
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdge(poly);
         ReadInLine(fp, "</Piece>");
     }
     ReadInLine(fp, "<!--");
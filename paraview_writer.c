@@ -15,6 +15,8 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
+#include "computational_geometry.h"
+#include "message_passing.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -23,6 +25,8 @@
 static void InitializeTransientCaseFile(PvSet *);
 static void WriteCaseFile(const Time *, PvSet *);
 static void WriteStructuredData(const Space *, const Model *, PvSet *);
+static void WriteParallelStructuredData(const Partition *const, PvSet *);
+static void ComputeDataExtent(const Partition *const, int [restrict], int [restrict]);
 static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, PvSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
@@ -47,10 +51,18 @@ void WriteStructuredDataParaview(const Time *time, const Space *space, const Mod
         .vec = {"Vel"},
     };
     snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&pvSet);
+    if (1 < space->part.rankN) { /* partitioned data are joined by a parallel file */
+        snprintf(pvSet.fext, sizeof(PvStr), ".pvts");
+    }
+    if (0 == space->part.rank) { /* only the root process writes case files */
+        if (0 == time->stepC) { /* initialization step */
+            InitializeTransientCaseFile(&pvSet);
+        }
+        WriteCaseFile(time, &pvSet);
+    }
+    if (1 < space->part.rankN) {
+        WriteParallelStructuredData(&(space->part), &pvSet);
     }
-    WriteCaseFile(time, &pvSet);
     WriteStructuredData(space, model, &pvSet);
     return;
 }
@@ -95,24 +107,91 @@ static void WriteCaseFile(const Time *time, PvSet *pvSet)
     fclose(fp);
     return;
 }
+/*
+ * Extents are measured in the node space of the entire domain, then the
+ * piece written by each partition can be placed in the whole data set.
+ */
+static void ComputeDataExtent(const Partition *const part, int whole[restrict], int piece[restrict])
+{
+    for (int s = 0, q = PWB; s < DIMS; ++s, q = q + 2) {
+        const int b = (PERIODIC == part->typeBC[q]) ? 0 : 1; /* first output node */
+        whole[2*s] = 0;
+        whole[2*s+1] = part->mt[s] - 2 * b;
+        piece[2*s] = part->ns[PIO][s][MIN] - part->n0[s] - b;
+        piece[2*s+1] = part->ns[PIO][s][MAX] - 1 - part->n0[s] - b;
+    }
+    return;
+}
+static void WriteParallelStructuredData(const Partition *const part, PvSet *pvSet)
+{
+    int whole[2*DIMS] = {0}; /* whole extent */
+    int piece[2*DIMS] = {0}; /* piece extent */
+    int *ext = NULL; /* piece extents of all partitions */
+    ComputeDataExtent(part, whole, piece);
+    if (0 == part->rank) {
+        ext = AssignStorage(2 * DIMS * part->rankN * sizeof(*ext), MEMIO);
+    }
+    GatherInt(2 * DIMS, piece, ext, part);
+    if (0 != part->rank) {
+        return;
+    }
+    if ((int)sizeof(PvStr) <= snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext)) {
+        ShowError("file name too long: %s", pvSet->bname);
+    }
+    FILE *fp = Fopen(pvSet->fname, "w");
+    fprintf(fp, "<?xml version=\"1.0\"?>\n");
+    fprintf(fp, "<VTKFile type=\"PStructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
+    fprintf(fp, "  <PStructuredGrid WholeExtent=\"%d %d %d %d %d %d\" GhostLevel=\"0\">\n",
+            whole[0], whole[1], whole[2], whole[3], whole[4], whole[5]);
+    fprintf(fp, "    <PPointData>\n");
+    for (int s = 0; s < pvSet->scaN; ++s) {
+        fprintf(fp, "      <PDataArray type=\"%s\" Name=\"%s\"/>\n", pvSet->floatType, pvSet->sca[s]);
+    }
+    for (int s = 0; s < pvSet->vecN; ++s) {
+        fprintf(fp, "      <PDataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\"/>\n", pvSet->floatType, pvSet->vec[s]);
+    }
+    fprintf(fp, "    </PPointData>\n");
+    fprintf(fp, "    <PPoints>\n");
+    fprintf(fp, "      <PDataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\"/>\n", pvSet->floatType);
+    fprintf(fp, "    </PPoints>\n");
+    for (int r = 0; r < part->rankN; ++r) {
+        const int *const e = ext + 2 * DIMS * r;
+        fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\" Source=\"%s_p%d.vts\"/>\n",
+                e[0], e[1], e[2], e[3], e[4], e[5], pvSet->bname, r);
+    }
+    fprintf(fp, "  </PStructuredGrid>\n");
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
+    RetrieveStorage(ext);
+    return;
+}
 static void WriteStructuredData(const Space *space, const Model *model, PvSet *pvSet)
 {
-    snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
+    const Partition *const part = &(space->part);
+    int len = 0; /* length of the composed file name */
+    if (1 < part->rankN) { /* data piece of each partition */
+        len = snprintf(pvSet->fname, sizeof(PvStr), "%s_p%d.vts", pvSet->bname, part->rank);
+    } else {
+        len = snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
+    }
+    if ((int)sizeof(PvStr) <= len) {
+        ShowError("file name too long: %s", pvSet->bname);
+    }
     FILE *fp = Fopen(pvSet->fname, "w");
     PvReal data = 0.0; /* paraview scalar data */
     PvReal Vec[3] = {0.0}; /* paraview vector data */
-    const Partition *const part = &(space->part);
-    const Node *const node = space->node;
-    const Real *restrict U = NULL;
+    const Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
-    IntVec ne = {0}; /* i, j, k node number in each part */
-    ne[X] = part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN] - 1;
-    ne[Y] = part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN] - 1;
-    ne[Z] = part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN] - 1;
+    int whole[2*DIMS] = {0}; /* whole extent */
+    int piece[2*DIMS] = {0}; /* piece extent */
+    ComputeDataExtent(part, whole, piece);
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
     fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
-    fprintf(fp, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
-    fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
+    fprintf(fp, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n",
+            whole[0], whole[1], whole[2], whole[3], whole[4], whole[5]);
+    fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n",
+            piece[0], piece[1], piece[2], piece[3], piece[4], piece[5]);
     fprintf(fp, "      <PointData>\n");
     for (int s = 0; s < pvSet->scaN; ++s) {
         fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" format=\"ascii\">\n", pvSet->floatType, pvSet->sca[s]);
@@ -121,7 +200,7 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
             for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
                 for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
+                    GatherU(idx, field->U[TO], U);
                     switch (s) {
                         case 0: /* rho */
                             data = U[0];
@@ -142,16 +221,16 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
                             data = ComputeTemperature(model->cv, U);
                             break;
                         case 6: /* node flag */
-                            data = node[idx].did;
+                            data = field->did[idx];
                             break;
                         case 7: /* face flag */
-                            data = node[idx].fid;
+                            data = field->fid[idx];
                             break;
                         case 8: /* layer flag */
-                            data = node[idx].lid;
+                            data = field->lid[idx];
                             break;
                         case 9: /* ghost flag */
-                            data = node[idx].gst;
+                            data = field->gst[idx];
                             break;
                         default:
                             break;
@@ -169,7 +248,7 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
             for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
                 for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
+                    GatherU(idx, field->U[TO], U);
                     Vec[X] = U[1] / U[0];
                     Vec[Y] = U[2] / U[0];
                     Vec[Z] = U[3] / U[0];
@@ -188,9 +267,9 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
     for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
         for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
             for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->n0[X]);
+                Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->n0[Y]);
+                Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->n0[Z]);
                 fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
             }
         }
@@ -344,6 +423,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     FILE *fp = Fopen(pvSet->fname, "w");
     PvReal Vec[3] = {0.0}; /* paraview vector data */
     const Polyhedron *poly = NULL;
+    RealVec pv = {0.0}; /* vertex in the current frame */
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
     fprintf(fp, "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
     fprintf(fp, "  <PolyData>\n");
@@ -363,9 +443,10 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
         fprintf(fp, "          ");
         for (int n = 0; n < poly->vertN; ++n) {
-            Vec[X] = poly->v[n][X];
-            Vec[Y] = poly->v[n][Y];
-            Vec[Z] = poly->v[n][Z];
+            BodyToCurrent(poly->v[n], poly, pv);
+            Vec[X] = pv[X];
+            Vec[Y] = pv[Y];
+            Vec[Z] = pv[Z];
             fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
         }
         fprintf(fp, "\n        </DataArray>\n");
@@ -14,6 +14,7 @@
 #include "postprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include "message_passing.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -27,6 +28,14 @@ int Postprocess(Time *time, Space *space, Model *model)
     ShowInfo("Postprocessing...\n");
     ShowInfo("  releasing memory...\n");
     ReleaseProgramMemory(time, space, model);
+    /* storage of the largest process */
+    Real count[2*(MEMN+1)] = {0.0};
+    CountStorage(count);
+    ReduceMax(2 * (MEMN + 1), count, &(space->part));
+    if (0 == space->part.rank) {
+        ShowStorage(count);
+    }
+    FinalizeMessagePassing();
     ShowInfo("  computing finished, successfully exit.\n");
     ShowInfo("Session");
     return 0;
@@ -38,12 +47,19 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     Polyhedron *poly = NULL;
     for (int n = geo->sphN; n < geo->totN; ++n) {
         poly = geo->poly + n;
+        if (n != poly->mesh) { /* an instance of a shared mesh */
+            continue;
+        }
         RetrieveStorage(poly->f);
         RetrieveStorage(poly->Nf);
         RetrieveStorage(poly->e);
         RetrieveStorage(poly->Ne);
         RetrieveStorage(poly->v);
         RetrieveStorage(poly->Nv);
+        RetrieveStorage(poly->bv);
+        RetrieveStorage(poly->bf);
+        RetrieveStorage(poly->gd);
+        RetrieveStorage(poly->gf);
     }
     RetrieveStorage(geo->poly);
     RetrieveStorage(geo->col);
@@ -55,7 +71,19 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     RetrieveStorage(part->typeIC);
     RetrieveStorage(part->posIC);
     RetrieveStorage(part->varIC);
-    RetrieveStorage(space->node);
+    RetrieveStorage(space->field.tag);
+    RetrieveStorage(space->field.var);
+    for (int s = 0; s < DIMS; ++s) {
+        RetrieveStorage(space->field.run[s].head);
+        RetrieveStorage(space->field.run[s].span);
+    }
+    RetrieveStorage(space->field.ibm.ghead);
+    RetrieveStorage(space->field.ibm.ghost);
+    RetrieveStorage(space->field.ibm.ihead);
+    RetrieveStorage(space->field.ibm.inter);
+    RetrieveStorage(space->field.ibm.sid);
+    RetrieveStorage(space->field.ibm.sw);
+    RetrieveStorage(space->field.ibm.band);
     /* time related */
     RetrieveStorage(time->lp);
     RetrieveStorage(time->pp);
@@ -14,6 +14,7 @@
 #include "preprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include <stdint.h> /* fixed width integer types */
 #include "case_loader.h"
 #include "cfd_parameters.h"
 #include "domain_partition.h"
@@ -22,6 +23,7 @@
  * Static Function Declarations
  ****************************************************************************/
 static void AllocateProgramMemory(Space *, Model *);
+static void AllocateFieldMemory(const int, const int, Field *);
 /****************************************************************************
  * Function Definitions
  ****************************************************************************/
@@ -49,12 +51,39 @@ static void AllocateProgramMemory(Space *space, Model *model)
     Partition *const part = &(space->part);
     Geometry *const geo = &(space->geo);
     const int totN = part->n[X] * part->n[Y] * part->n[Z];
-    space->node = AssignStorage(totN * sizeof(*space->node));
+    AllocateFieldMemory(totN, model->levelN, &(space->field));
     if (0 != geo->totN) {
-        geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
-        geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+        geo->col = AssignStorage(geo->totN * sizeof(*geo->col), MEMGEOMETRY);
+        geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly), MEMGEOMETRY);
+    }
+    model->mat = AssignStorage(sizeof(*model->mat), MEMGEOMETRY);
+    return;
+}
+/*
+ * Field data are stored as structure of arrays: each identifier and each
+ * conservative variable at each time level occupies a contiguous array.
+ * Arrays are padded to a common stride and aligned to ALIGNB bytes so that
+ * sweeps only stream the variables they touch and neighbouring nodes can be
+ * processed by vector instructions.
+ * Only the time levels required by the temporal scheme are allocated.
+ */
+static void AllocateFieldMemory(const int totN, const int levelN, Field *field)
+{
+    const int alignN = ALIGNB / sizeof(FdReal); /* number of reals in an alignment unit */
+    field->stride = ((totN + alignN - 1) / alignN) * alignN;
+    field->tag = AssignStorage(4 * field->stride * sizeof(*field->tag), MEMFIELD);
+    field->did = field->tag;
+    field->fid = field->did + field->stride;
+    field->lid = field->fid + field->stride;
+    field->gst = field->lid + field->stride;
+    field->var = AssignStorage((levelN * DIMU * field->stride + alignN) * sizeof(*field->var), MEMFIELD);
+    FdReal *U = field->var + ((alignN - ((uintptr_t)field->var % ALIGNB) / sizeof(FdReal)) % alignN);
+    for (int tn = 0; tn < levelN; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            field->U[tn][n] = U;
+            U = U + field->stride;
+        }
     }
-    model->mat = AssignStorage(sizeof(*model->mat));
     return;
 }
 /* a good practice: end file with a newline */
@@ -15,8 +15,13 @@
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* shared memory multithreading */
+#endif
 #include "calculator.h"
 #include "case_generator.h"
+#include "message_passing.h"
+#include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -84,6 +89,18 @@ int EnterProgram(int argc, char *argv[], Control *control, Space *space)
                 Sscanf(argv[1], 3, "%d*%d*%d", &(control->proc[X]),
                         &(control->proc[Y]), &(control->proc[Z]));
                 break;
+                /* storage budget per process: -b megabytes */
+            case 'b':
+                ++argv;
+                --argc;
+                Sscanf(argv[1], 1, ParseFormat("%lg"), &(control->budget));
+                break;
+                /* reference solution to write or compare with: -c file */
+            case 'c':
+                ++argv;
+                --argc;
+                control->reference = argv[1];
+                break;
             default:
                 ShowError("bad option: %s\n", argv[1]);
                 exit(EXIT_FAILURE);
@@ -103,6 +120,14 @@ int EnterProgram(int argc, char *argv[], Control *control, Space *space)
 static void ConfigureProgram(Control *control, Space *space)
 {
     Partition *const part = &(space->part);
+    part->rank = 0;
+    part->rankN = 1; /* only the mpi mode shares the domain among processes */
+    if (0 < control->budget) {
+        LimitStorage((size_t)(control->budget * 1048576.0));
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(1); /* only the omp mode runs multithreaded */
+#endif
     switch (control->runMode) {
         case 'i': /* gui mode */
             ShowPreamble(control);
@@ -114,13 +139,22 @@ static void ConfigureProgram(Control *control, Space *space)
             part->procN = 1;
             break;
         case 'o': /* omp mode */
-            /* fall through */
+            part->proc[X] = MaxInt(control->proc[X], 1);
+            part->proc[Y] = MaxInt(control->proc[Y], 1);
+            part->proc[Z] = MaxInt(control->proc[Z], 1);
+            part->procN = part->proc[X] * part->proc[Y] * part->proc[Z];
+#ifdef _OPENMP
+            omp_set_num_threads(part->procN);
+#else
+            ShowWarning("openmp not enabled by compiler, threads ignored");
+#endif
+            break;
         case 'm': /* mpi mode */
-            part->proc[X] = control->proc[X];
-            part->proc[Y] = control->proc[Y];
-            part->proc[Z] = control->proc[Z];
-            part->procN = control->proc[X] *
-                control->proc[Y] * control->proc[Z];
+            part->proc[X] = MaxInt(control->proc[X], 1);
+            part->proc[Y] = MaxInt(control->proc[Y], 1);
+            part->proc[Z] = MaxInt(control->proc[Z], 1);
+            part->procN = part->proc[X] * part->proc[Y] * part->proc[Z];
+            InitializeMessagePassing(part);
             break;
         case 'g': /* gpu mode */
             break;
@@ -186,12 +220,17 @@ static void ShowManual(void)
 {
     ShowInfo("\n            ArtraCFD User Manual\n");
     ShowInfo("SYNOPSIS:\n");
-    ShowInfo("        artracfd [-m runmode] [-n nprocessors]\n");
+    ShowInfo("        artracfd [-m runmode] [-n nprocessors] [-b megabytes] [-c reference]\n");
     ShowInfo("OPTIONS:\n");
     ShowInfo("        -m runmode        run mode: gui, serial, omp, mpi, gpu\n");
     ShowInfo("        -n nprocessors    processors per dimension: nx*ny*nz\n");
+    ShowInfo("        -b megabytes      storage budget per process\n");
+    ShowInfo("        -c reference      write or compare a full precision reference solution\n");
     ShowInfo("NOTES:\n");
     ShowInfo("        default run mode is gui\n");
+    ShowInfo("        omp mode runs nx*ny*nz threads\n");
+    ShowInfo("        without a budget, storage is not limited\n");
+    ShowInfo("        a missing reference is written, otherwise compared in solution_deviation.csv\n");
     return;
 }
 /* a good practice: end file with a newline */
@@ -0,0 +1,274 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "roofline.h"
+#include <stdio.h> /* standard library for input and output */
+#include "timer.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef void (*PeakProbe)(const long, Real [restrict]);
+typedef enum {
+    STREAMN = 4194304, /* elements of each array of the bandwidth probe */
+    PEAKLANE = 32, /* independent multiply-add chains of the peak probe */
+    PROBEN = 5, /* repetitions of a probe, the best is taken */
+} RoofConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static double MeasureBandwidth(void);
+static double MeasurePeak(const int isa);
+static void PeakLanes(const long, Real [restrict]);
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void PeakLanesAVX2(const long, Real [restrict]);
+TARGET("avx512f") static void PeakLanesAVX512(const long, Real [restrict]);
+#endif
+KERNEL void PeakKernel(const long, Real [restrict]);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+#ifdef ARTRACFD_X86
+static PeakProbe ProbePeak[3] = {
+    PeakLanes,
+    PeakLanesAVX2,
+    PeakLanesAVX512};
+#else
+static PeakProbe ProbePeak[3] = {
+    PeakLanes,
+    PeakLanes,
+    PeakLanes};
+#endif
+static const char *const kernelName[RFN] = {"sweepx", "sweepy", "sweepz", "ibm"};
+static int active = 0; /* accounting is active */
+static double bandwidth = 0.0; /* sustainable memory bandwidth in bytes per second */
+static double peak = 0.0; /* floating point peak in operations per second */
+static Timer kernelStart[RFN]; /* start moment of each kernel */
+static double kernelTime[RFN] = {0.0}; /* accumulated time */
+static double kernelFlop[RFN] = {0.0}; /* accumulated floating point operations */
+static double kernelByte[RFN] = {0.0}; /* accumulated memory traffic in bytes */
+static long kernelCall[RFN] = {0}; /* number of kernel calls */
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void MeasureRoof(const int isa)
+{
+    bandwidth = MeasureBandwidth();
+    peak = MeasurePeak(isa);
+    active = 1;
+    return;
+}
+/*
+ * STREAM triad a = b + q * c, counted as two loads and one store per element
+ * as in the STREAM convention. The arrays are first touched in parallel to
+ * place pages near the threads using them.
+ */
+static double MeasureBandwidth(void)
+{
+    Real *const a = AssignStorage(3 * (size_t)STREAMN * sizeof(*a), MEMSCRATCH);
+    Real *const b = a + STREAMN;
+    Real *const c = b + STREAMN;
+    const Real q = 3.0;
+    double best = 0.0;
+    Timer tm;
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < STREAMN; ++n) {
+        a[n] = 0.0;
+        b[n] = 1.0;
+        c[n] = 2.0;
+    }
+    for (int m = 0; m < PROBEN; ++m) {
+        TickTime(&tm);
+        #pragma omp parallel for schedule(static)
+        for (int n = 0; n < STREAMN; ++n) {
+            a[n] = b[n] + q * c[n];
+        }
+        const double elapse = TockTime(&tm);
+        if ((0.0 < elapse) && ((0.0 == best) || (elapse < best))) {
+            best = elapse;
+        }
+    }
+    RetrieveStorage(a);
+    return (0.0 < best) ? 3.0 * STREAMN * sizeof(Real) / best : 0.0;
+}
+/*
+ * Each thread runs independent multiply-add chains on the dispatched code
+ * path of batched kernels, two operations per chain and iteration. Chains
+ * are kept in a cache resident array as operands of the solver kernels, so
+ * the result is the practical peak of portable vector loops rather than the
+ * nominal peak of the processor.
+ */
+static double MeasurePeak(const int isa)
+{
+    const long iterN = 4000000;
+    double best = 0.0;
+    int threadN = 0;
+    Timer tm;
+    for (int m = 0; m < PROBEN; ++m) {
+        threadN = 0;
+        TickTime(&tm);
+        #pragma omp parallel
+        {
+            Real acc[PEAKLANE];
+            for (int l = 0; l < PEAKLANE; ++l) {
+                acc[l] = (Real)l;
+            }
+            ProbePeak[isa](iterN, acc);
+            #pragma omp atomic
+            ++threadN;
+            if (0.0 > acc[0]) { /* keep results alive */
+                ShowInfo("%g", acc[0]);
+            }
+        }
+        const double elapse = TockTime(&tm);
+        if ((0.0 < elapse) && ((0.0 == best) || (elapse < best))) {
+            best = elapse;
+        }
+    }
+    return (0.0 < best) ? 2.0 * PEAKLANE * (double)iterN * threadN / best : 0.0;
+}
+static void PeakLanes(const long iterN, Real acc[restrict])
+{
+    PeakKernel(iterN, acc);
+    return;
+}
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void PeakLanesAVX2(const long iterN, Real acc[restrict])
+{
+    PeakKernel(iterN, acc);
+    return;
+}
+TARGET("avx512f") static void PeakLanesAVX512(const long iterN, Real acc[restrict])
+{
+    PeakKernel(iterN, acc);
+    return;
+}
+#endif
+KERNEL void PeakKernel(const long iterN, Real acc[restrict])
+{
+    const Real mul = 0.999999;
+    const Real add = 1.0e-6;
+    for (long n = 0; n < iterN; ++n) {
+        #pragma omp simd
+        for (int l = 0; l < PEAKLANE; ++l) {
+            acc[l] = acc[l] * mul + add;
+        }
+    }
+    return;
+}
+void StartKernel(const int k)
+{
+    if (0 != active) {
+        TickTime(kernelStart + k);
+    }
+    return;
+}
+void StopKernel(const int k)
+{
+    if (0 != active) {
+        kernelTime[k] = kernelTime[k] + TockTime(kernelStart + k);
+        ++kernelCall[k];
+    }
+    return;
+}
+/*
+ * Operations are counted from the source of the flux routines, with one
+ * operation for each addition, multiplication, division, and square root.
+ * A solved node computes one interface flux, which is a characteristic
+ * decomposition, the projection of the stencil, the splitting of the
+ * characteristic fluxes, the WENO reconstruction of both splittings, the
+ * inverse projection, and a diffusive flux if viscous; followed by the flux
+ * difference and the solution operator. The traffic is the compulsory one:
+ * the stencils are taken as cache resident, so a node reads the conserved
+ * variables of two time levels and its domain identifier, and writes the
+ * conserved variables of one time level.
+ */
+void CountSweepCost(const int s, const double nodeN, const Model *model)
+{
+    if (0 == active) {
+        return;
+    }
+    const double tot = model->sR - model->sL; /* width of the direct stencil */
+    const double weno = (5 == model->sR - model->sL) ? 68.0 : 21.0; /* operations per lane */
+    double flop = 155.0 + (tot + 1.0) * 2.0 * DIMU * DIMU + 2.0 * tot * DIMU +
+        2.0 * DIMU * weno + 3.0 * DIMU * DIMU;
+    if (0.0 < model->refMu) {
+        flop = flop + 120.0;
+    }
+    flop = flop + 3.0 * DIMU + 4.0 * DIMU;
+    const double byte = 3.0 * DIMU * sizeof(FdReal) + sizeof(int);
+    kernelFlop[RFSWEEP+s] = kernelFlop[RFSWEEP+s] + nodeN * flop;
+    kernelByte[RFSWEEP+s] = kernelByte[RFSWEEP+s] + nodeN * byte;
+    return;
+}
+/*
+ * A ghost node reads its cached geometric data, reconstructs the boundary
+ * values, and writes its conserved variables. A stencil node reads its
+ * index, weight, and conserved variables, and is mapped and weighted.
+ */
+void CountIbmCost(const double ghostN, const double stencilN)
+{
+    if (0 == active) {
+        return;
+    }
+    kernelFlop[RFIBM] = kernelFlop[RFIBM] + 70.0 * ghostN + 34.0 * stencilN;
+    kernelByte[RFIBM] = kernelByte[RFIBM] + (sizeof(Ghost) + DIMU * sizeof(FdReal)) * ghostN +
+        (sizeof(int) + sizeof(Real) + DIMU * sizeof(FdReal)) * stencilN;
+    return;
+}
+/*
+ * The arithmetic intensity of a kernel is compared with the ridge point of
+ * the roof, peak / bandwidth: a kernel below it is bounded by bandwidth and
+ * a kernel above it by the floating point peak. The attainable rate is the
+ * lower roof at its intensity.
+ */
+void WriteRooflineReport(const char *bname)
+{
+    if (0 == active) {
+        return;
+    }
+    char fname[256] = {'\0'};
+    const double ridge = (0.0 < bandwidth) ? peak / bandwidth : 0.0;
+    snprintf(fname, sizeof fname, "%s.csv", bname);
+    FILE *fp = fopen(fname, "w");
+    if (NULL != fp) {
+        fprintf(fp, "# bandwidth GB/s, %.6g\n# peak GFLOP/s, %.6g\n# ridge FLOP/byte, %.6g\n",
+                bandwidth * 1.0e-9, peak * 1.0e-9, ridge);
+        fprintf(fp, "# kernel, calls, time, GFLOP, GB, FLOP/byte, GFLOP/s, GB/s, "
+                "percent of attainable, bound\n");
+    }
+    ShowInfo("  roofline: bandwidth %.4g GB/s, peak %.4g GFLOP/s\n", bandwidth * 1.0e-9, peak * 1.0e-9);
+    for (int k = 0; k < RFN; ++k) {
+        if (0.0 >= kernelByte[k]) { /* kernel without work */
+            continue;
+        }
+        const double time = (0.0 < kernelTime[k]) ? kernelTime[k] : 1.0e-6;
+        const double intensity = (0.0 < kernelByte[k]) ? kernelFlop[k] / kernelByte[k] : 0.0;
+        const double flops = kernelFlop[k] / time;
+        const double bytes = kernelByte[k] / time;
+        const double roof = (intensity < ridge) ? intensity * bandwidth : peak;
+        const double share = (0.0 < roof) ? 100.0 * flops / roof : 0.0;
+        const char *bound = (intensity < ridge) ? "bandwidth" : "compute";
+        if (NULL != fp) {
+            fprintf(fp, "%s, %ld, %.6g, %.6g, %.6g, %.4g, %.4g, %.4g, %.4g, %s\n", kernelName[k],
+                    kernelCall[k], kernelTime[k], kernelFlop[k] * 1.0e-9, kernelByte[k] * 1.0e-9,
+                    intensity, flops * 1.0e-9, bytes * 1.0e-9, share, bound);
+        }
+        ShowInfo("  %-7s %8.4g GFLOP/s %8.4g GB/s %6.3g FLOP/byte %5.3g%% of %s roof\n",
+                kernelName[k], flops * 1.0e-9, bytes * 1.0e-9, intensity, share, bound);
+    }
+    if (NULL != fp) {
+        fclose(fp);
+    }
+    return;
+}
+/* a good practice: end file with a newline */
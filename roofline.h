@@ -0,0 +1,66 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_ROOFLINE_H_ /* if undefined */
+#define ARTRACFD_ROOFLINE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Kernels of the roofline report
+ */
+typedef enum {
+    RFSWEEP = 0, /* spatial operator sweeps in x, y, z */
+    RFIBM = 3, /* immersed boundary treatment passes */
+    RFN = 4, /* number of kernels */
+} RoofKernel;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Machine roof
+ *
+ * Function
+ *      Enable the roofline accounting and measure the sustainable memory
+ *      bandwidth by a STREAM triad and the floating point peak by
+ *      independent multiply-add chains on the dispatched instruction set,
+ *      both with all threads. Without this call, accounting is inactive.
+ */
+extern void MeasureRoof(const int isa);
+/*
+ * Kernel accounting
+ *
+ * Function
+ *      Time a kernel between its start and stop, and add the floating point
+ *      operations and the memory traffic of its work by a static cost model.
+ *      Sweeps are charged per solved node, and immersed boundary passes per
+ *      treated ghost node and applied stencil node.
+ */
+extern void StartKernel(const int k);
+extern void StopKernel(const int k);
+extern void CountSweepCost(const int s, const double nodeN, const Model *);
+extern void CountIbmCost(const double ghostN, const double stencilN);
+/*
+ * Roofline report
+ *
+ * Function
+ *      Write the achieved bandwidth and floating point rate of kernels
+ *      against the machine roof as bname.csv and show a summary.
+ */
+extern void WriteRooflineReport(const char *bname);
+#endif
+/* a good practice: end file with a newline */
@@ -20,136 +20,104 @@
 #include "immersed_boundary.h"
 #include "computational_geometry.h"
 #include "linear_system.h"
+#include "message_passing.h"
+#include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void SumSurfaceForce(const int, Space *, const Model *, int [restrict], Real [restrict]);
 static void ApplyKinematics(const Real, const Real, Space *);
 static void ApplyCollision(Space *);
+static void SweepColCandidate(const Real [restrict], const Geometry *const, int [restrict]);
+static int CompareSpan(const void *, const void *);
 static void DetectColState(const int, const int, const int, const int, const int,
-        const int [restrict][DIMS], const Node *const, const Partition *const,
+        const int [restrict][DIMS], const Field *const, const Partition *const,
         Geometry *const);
 static void AddColObject(const int [restrict], const int, Geometry *const);
+static void MergeColObject(Real [], const Partition *const, Geometry *const);
 static void ApplyMotion(const Real, Space *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void EvolveSolidDynamics(const Real now, const Real dt, Space *space, const Model *model)
 {
+    StartRegion(RGFORCE);
     IntegrateSurfaceForce(space, model);
+    StopRegion(RGFORCE);
+    StartRegion(RGKINEMATICS);
     ApplyKinematics(now, dt, space);
+    StopRegion(RGKINEMATICS);
     if (1 != model->psi) {
+        StartRegion(RGCOLLISION);
         ApplyCollision(space);
+        StopRegion(RGCOLLISION);
     }
+    StartRegion(RGMOTION);
     ApplyMotion(dt, space);
+    StopRegion(RGMOTION);
+    StartRegion(RGGEOFIELD);
     ComputeGeometricField(space, model);
+    StopRegion(RGGEOFIELD);
+    StartRegion(RGIBM);
     TreatImmersedBoundary(TO, space, model);
+    StopRegion(RGIBM);
     return;
 }
+/*
+ * Polyhedrons sum the forces of their own ghost nodes, which are summed in
+ * parallel over polyhedrons. The sums of partitions are then merged and
+ * calibrated polyhedron by polyhedron.
+ */
 void IntegrateSurfaceForce(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
     Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
     const Real zero = 0.0;
     const Real percent = FLT_EPSILON * FLT_EPSILON;
     Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    int (*count)[2] = AssignStorage(geo->totN * sizeof(*count), MEMSCRATCH); /* interfacial and ghost nodes */
+    Real (*var)[DIMS] = AssignStorage(geo->totN * sizeof(*var), MEMSCRATCH); /* force offset, mean, variance */
     int lidN = 0; /* count total number of interfacial nodes */
     int gstN = 0; /* count total number of ghost nodes */
-    RealVec pG = {zero}; /* ghost point */
-    RealVec pO = {zero}; /* boundary point */
-    RealVec pI = {zero}; /* image point */
-    RealVec N = {zero}; /* normal */
-    Real Uo[DIMUo] = {zero};
-    RealVec V = {zero}; /* velocity vector */
-    RealVec r = {zero}; /* position vector */
-    RealVec Fp = {zero}; /* pressure force */
-    RealVec Fv = {zero}; /* viscous force */
-    RealVec Fs = {zero}; /* surface force */
-    RealVec Tt = {zero}; /* torque */
-    RealVec fvar = {zero}; /* force offset, mean, variance */
-    Real Vn = zero; /* velocity projection */
-    Real mu = zero; /* viscosity */
+    Real *fvar = NULL; /* force offset, mean, variance */
     Real ds = zero; /* infinitesimal area for integration */
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int n = 0; n < geo->totN; ++n) {
+        if (0 < geo->poly[n].state) { /* surface force negligible */
+            continue;
+        }
+        SumSurfaceForce(n, space, model, count[n], var[n]);
+    }
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (0 < poly->state) { /* surface force negligible */
             continue;
         }
-        /* reset some non accumulative information to zero */
-        memset(poly->Fp, 0, DIMS * sizeof(*poly->Fp));
-        memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
-        memset(poly->Tt, 0, DIMS * sizeof(*poly->Tt));
-        memset(fvar, 0, DIMS * sizeof(*fvar));
-        lidN = 0;
-        gstN = 0;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((2 == node[idx].lid) && (n + 1 == node[idx].did)) {
-                        ++lidN; /* an interfacial node of current geometry */
-                    }
-                    if ((2 != node[idx].gst) || (n + 1 != node[idx].did)) {
-                        continue;
-                    }
-                    ++gstN; /* a ghost node of current geometry */
-                    /* surface force exerted by fluid (pressure + shear force) */
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    r[X] = pO[X] - poly->O[X];
-                    r[Y] = pO[Y] - poly->O[Y];
-                    r[Z] = pO[Z] - poly->O[Z];
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    Fp[X] = Uo[4] * N[X];
-                    Fp[Y] = Uo[4] * N[Y];
-                    Fp[Z] = Uo[4] * N[Z];
-                    if (1 == gstN) {
-                        fvar[0] = Uo[4];
-                    }
-                    fvar[1] = fvar[1] + Uo[4] - fvar[0];
-                    fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
-                    if ((zero < model->refMu) && (zero < poly->cf)) {
-                        mu = model->refMu * Viscosity(Uo[5] * model->refT);
-                        Cross(poly->W[TO], r, V);
-                        V[X] = Uo[1] - (poly->V[TO][X] + V[X]);
-                        V[Y] = Uo[2] - (poly->V[TO][Y] + V[Y]);
-                        V[Z] = Uo[3] - (poly->V[TO][Z] + V[Z]);
-                        Vn = Dot(V, N);
-                        Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
-                        Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
-                        Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
-                    } else {
-                        memset(Fv, 0, DIMS * sizeof(*Fv));
-                    }
-                    Fs[X] = Fp[X] + Fv[X];
-                    Fs[Y] = Fp[Y] + Fv[Y];
-                    Fs[Z] = Fp[Z] + Fv[Z];
-                    Cross(r, Fs, Tt);
-                    /* integration sum */
-                    for (int s = 0; s < DIMS; ++s) {
-                        poly->Fp[s] = poly->Fp[s] + Fp[s];
-                        poly->Fv[s] = poly->Fv[s] + Fv[s];
-                        poly->Tt[s] = poly->Tt[s] + Tt[s];
-                    }
-                }
+        lidN = count[n][0];
+        gstN = count[n][1];
+        fvar = var[n];
+        if (1 < part->rankN) { /* merge the sums of all partitions */
+            Real sum[12] = {lidN, gstN, fvar[1] + gstN * fvar[0],
+                poly->Fp[X], poly->Fp[Y], poly->Fp[Z],
+                poly->Fv[X], poly->Fv[Y], poly->Fv[Z],
+                poly->Tt[X], poly->Tt[Y], poly->Tt[Z]};
+            ReduceSum(12, sum, part);
+            for (int s = 0; s < DIMS; ++s) {
+                poly->Fp[s] = sum[3+s];
+                poly->Fv[s] = sum[6+s];
+                poly->Tt[s] = sum[9+s];
+            }
+            if (zero < sum[1]) { /* shift local sums to the global mean to merge the variance */
+                const Real delta = fvar[0] - sum[2] / sum[1];
+                fvar[2] = fvar[2] + 2.0 * delta * fvar[1] + gstN * delta * delta;
+                ReduceSum(1, fvar + 2, part);
+                fvar[0] = sum[2] / sum[1];
+                fvar[1] = zero;
             }
+            lidN = sum[0];
+            gstN = sum[1];
         }
         /* calibrate the sum of discrete forces into integration */
         if ((0 == lidN) || (0 == gstN)) { /* no surface force exerted */
@@ -167,6 +135,99 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
             poly->Tt[s] = -poly->Tt[s] * ds;
         }
     }
+    RetrieveStorage(var);
+    RetrieveStorage(count);
+    return;
+}
+static void SumSurfaceForce(const int n, Space *space, const Model *model,
+        int count[restrict], Real fvar[restrict])
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    const Interface *const ibm = &(field->ibm);
+    Polyhedron *const poly = space->geo.poly + n;
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const IntVec n0 = {part->n0[X], part->n0[Y], part->n0[Z]};
+    const Real zero = 0.0;
+    const int layer = 2; /* layer of the integration */
+    const Ghost *ghost = NULL;
+    int idx = 0; /* linear array index math variable */
+    int gstN = 0; /* count total number of ghost nodes */
+    RealVec pG = {zero}; /* ghost point */
+    const Real *pO = NULL; /* boundary point */
+    const Real *N = NULL; /* normal */
+    Real U[DIMU] = {zero};
+    Real Uo[DIMUo] = {zero};
+    RealVec V = {zero}; /* velocity vector */
+    RealVec r = {zero}; /* position vector */
+    RealVec Fp = {zero}; /* pressure force */
+    RealVec Fv = {zero}; /* viscous force */
+    RealVec Fs = {zero}; /* surface force */
+    RealVec Tt = {zero}; /* torque */
+    Real Vn = zero; /* velocity projection */
+    Real mu = zero; /* viscosity */
+    /* reset some non accumulative information to zero */
+    memset(poly->Fp, 0, DIMS * sizeof(*poly->Fp));
+    memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
+    memset(poly->Tt, 0, DIMS * sizeof(*poly->Tt));
+    memset(fvar, 0, DIMS * sizeof(*fvar));
+    count[0] = 0;
+    count[1] = 0;
+    if (part->gl < layer) {
+        return;
+    }
+    /* interfacial nodes and ghost nodes of the layer of current geometry */
+    const int l = (layer - 1) * space->geo.totN + n;
+    count[0] = ibm->ihead[l+1] - ibm->ihead[l];
+    for (int m = ibm->ghead[l]; m < ibm->ghead[l+1]; ++m) {
+        ghost = ibm->ghost + m;
+        idx = ghost->idx;
+        ++gstN; /* a ghost node of current geometry */
+        /* surface force exerted by fluid (pressure + shear force) */
+        pG[X] = MapPoint(ghost->n[X], sMin[X], d[X], n0[X]);
+        pG[Y] = MapPoint(ghost->n[Y], sMin[Y], d[Y], n0[Y]);
+        pG[Z] = MapPoint(ghost->n[Z], sMin[Z], d[Z], n0[Z]);
+        pO = ghost->pO;
+        N = ghost->N;
+        r[X] = pO[X] - poly->O[X];
+        r[Y] = pO[Y] - poly->O[Y];
+        r[Z] = pO[Z] - poly->O[Z];
+        GatherU(idx, field->U[TO], U);
+        MapPrimitive(model->gamma, model->gasR, U, Uo);
+        Fp[X] = Uo[4] * N[X];
+        Fp[Y] = Uo[4] * N[Y];
+        Fp[Z] = Uo[4] * N[Z];
+        if (1 == gstN) {
+            fvar[0] = Uo[4];
+        }
+        fvar[1] = fvar[1] + Uo[4] - fvar[0];
+        fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
+        if ((zero < model->refMu) && (zero < poly->cf)) {
+            mu = model->refMu * Viscosity(Uo[5] * model->refT);
+            Cross(poly->W[TO], r, V);
+            V[X] = Uo[1] - (poly->V[TO][X] + V[X]);
+            V[Y] = Uo[2] - (poly->V[TO][Y] + V[Y]);
+            V[Z] = Uo[3] - (poly->V[TO][Z] + V[Z]);
+            Vn = Dot(V, N);
+            Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
+            Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
+            Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
+        } else {
+            memset(Fv, 0, DIMS * sizeof(*Fv));
+        }
+        Fs[X] = Fp[X] + Fv[X];
+        Fs[Y] = Fp[Y] + Fv[Y];
+        Fs[Z] = Fp[Z] + Fv[Z];
+        Cross(r, Fs, Tt);
+        /* integration sum */
+        for (int s = 0; s < DIMS; ++s) {
+            poly->Fp[s] = poly->Fp[s] + Fp[s];
+            poly->Fv[s] = poly->Fv[s] + Fv[s];
+            poly->Tt[s] = poly->Tt[s] + Tt[s];
+        }
+    }
+    count[1] = gstN;
     return;
 }
 static void ApplyKinematics(const Real now, const Real dt, Space *space)
@@ -213,13 +274,10 @@ static void ApplyKinematics(const Real now, const Real dt, Space *space)
 static void ApplyCollision(Space *space)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
+    const Interface *const ibm = &(field->ibm);
     Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
     const Real zero = 0.0;
     const Real one = 1.0;
     const int coltag = INT_MAX / 2; /* colliding polyhedron marker */
@@ -227,8 +285,6 @@ static void ApplyCollision(Space *space)
     Polyhedron *polp = NULL;
     Polyhedron *poln = NULL;
     Collision *col = NULL;
-    int idx = 0; /* linear array index math variable */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     RealVec Vo = {zero}; /* original translational velocity */
     RealVec Wo = {zero}; /* original rotational velocity */
     RealVec V = {zero}; /* relative translational velocity */
@@ -240,27 +296,37 @@ static void ApplyCollision(Space *space)
     Real mp = zero; /* mass */
     Real mn = zero; /* mass */
     Real meff = zero; /* effective mass */
+    Real *colList = NULL; /* collision list of all partitions */
+    RealVec pad = {zero}; /* reach of the search path in addition to a node */
+    int *cand = AssignStorage(geo->totN * sizeof(*cand), MEMSCRATCH); /* collision candidate */
+    if (1 < part->rankN) {
+        colList = AssignStorage(geo->totN * (DIMS + 1) * sizeof(*colList), MEMSCRATCH);
+    }
+    for (int n = 0; n < part->pathSep[1]; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            pad[s] = MaxReal(pad[s], abs(part->path[n][s]) * dd[s]);
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        pad[s] = pad[s] + dd[s];
+    }
+    SweepColCandidate(pad, geo, cand);
     for (int p = 0; p < geo->totN; ++p) {
         polp = geo->poly + p;
         if (1 == polp->state) { /* stationary object */
             continue;
         }
+        if (0 == cand[p]) { /* no polyhedron within reach */
+            continue;
+        }
         geo->colN = 0; /* reset */
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].lid) || (p + 1 != node[idx].did)) {
-                        continue;
-                    }
-                    DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
-                }
-            }
+        /* search around the first interfacial layer of polyhedron */
+        for (int m = ibm->ihead[p]; m < ibm->ihead[p+1]; ++m) {
+            DetectColState(ibm->inter[m][Z], ibm->inter[m][Y], ibm->inter[m][X], p + 1,
+                    part->pathSep[1], part->path, field, part, geo);
+        }
+        if (1 < part->rankN) {
+            MergeColObject(colList, part, geo);
         }
         /* skip none contacting polyhedron */
         if (0 == geo->colN) {
@@ -329,10 +395,85 @@ static void ApplyCollision(Space *space)
         memcpy(polp->V[TN], polp->V[TO], DIMS * sizeof(*polp->V[TO]));
         memcpy(polp->W[TN], polp->W[TO], DIMS * sizeof(*polp->W[TO]));
     }
+    RetrieveStorage(colList);
+    RetrieveStorage(cand);
     return;
 }
+/*
+ * Broad phase of collision: a heterogeneous node on the search path of an
+ * interfacial node lies in the bounding box of its polyhedron, hence only
+ * polyhedrons with boxes closer than twice the padding can collide. Padded
+ * boxes are sorted by their lower bound on the axis of the largest spread
+ * of centers and swept on that axis, and the overlap on all axes marks both
+ * polyhedrons of a pair as candidates. Since the geometry is global, the
+ * candidates are the same on all partitions.
+ */
+static void SweepColCandidate(const Real pad[restrict], const Geometry *const geo, int cand[restrict])
+{
+    const Polyhedron *polp = NULL;
+    const Polyhedron *poln = NULL;
+    Real (*span)[LIMIT+1] = AssignStorage(geo->totN * sizeof(*span), MEMSCRATCH); /* bounds and index */
+    RealVec sum = {0.0}; /* sum of centers */
+    RealVec sqr = {0.0}; /* sum of squared centers */
+    int a = X; /* sweep axis */
+    int overlap = 0; /* boxes overlap */
+    for (int p = 0; p < geo->totN; ++p) {
+        polp = geo->poly + p;
+        cand[p] = 0;
+        for (int s = 0; s < DIMS; ++s) {
+            const Real c = 0.5 * (polp->box[s][MIN] + polp->box[s][MAX]);
+            sum[s] = sum[s] + c;
+            sqr[s] = sqr[s] + c * c;
+        }
+    }
+    for (int s = Y; s < DIMS; ++s) {
+        if (sqr[s] * geo->totN - sum[s] * sum[s] > sqr[a] * geo->totN - sum[a] * sum[a]) {
+            a = s;
+        }
+    }
+    for (int p = 0; p < geo->totN; ++p) {
+        polp = geo->poly + p;
+        span[p][MIN] = polp->box[a][MIN] - pad[a];
+        span[p][MAX] = polp->box[a][MAX] + pad[a];
+        span[p][LIMIT] = p;
+    }
+    qsort(span, geo->totN, sizeof(*span), CompareSpan);
+    for (int m = 0; m < geo->totN; ++m) {
+        const int p = (int)span[m][LIMIT];
+        polp = geo->poly + p;
+        for (int l = m + 1; (l < geo->totN) && (span[l][MIN] <= span[m][MAX]); ++l) {
+            const int n = (int)span[l][LIMIT];
+            poln = geo->poly + n;
+            if ((1 == polp->state) && (1 == poln->state)) { /* stationary pair */
+                continue;
+            }
+            overlap = 1;
+            for (int s = 0; s < DIMS; ++s) {
+                if ((polp->box[s][MIN] - pad[s] > poln->box[s][MAX] + pad[s]) ||
+                        (poln->box[s][MIN] - pad[s] > polp->box[s][MAX] + pad[s])) {
+                    overlap = 0;
+                }
+            }
+            if (0 != overlap) {
+                cand[p] = 1;
+                cand[n] = 1;
+            }
+        }
+    }
+    RetrieveStorage(span);
+    return;
+}
+static int CompareSpan(const void *a, const void *b)
+{
+    const Real *const sa = a;
+    const Real *const sb = b;
+    if (sa[MIN] != sb[MIN]) {
+        return (sa[MIN] < sb[MIN]) ? -1 : 1;
+    }
+    return (sa[LIMIT] < sb[LIMIT]) ? -1 : ((sa[LIMIT] > sb[LIMIT]) ? 1 : 0);
+}
 static void DetectColState(const int k, const int j, const int i, const int did,
-        const int end, const int path[restrict][DIMS], const Node *const node,
+        const int end, const int path[restrict][DIMS], const Field *const field,
         const Partition *const part, Geometry *const geo)
 {
     /* search around the specified node to find colliding objects */
@@ -342,15 +483,15 @@ static void DetectColState(const int k, const int j, const int i, const int did,
         kh = k + path[n][Z];
         jh = j + path[n][Y];
         ih = i + path[n][X];
-        if (!InPartBox(kh, jh, ih, part->ns[PIN])) {
+        if (!InPartBox(kh, jh, ih, part->ns[PEX])) {
             continue;
         }
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
-        if (0 == node[idx].did) { /* a fluid node is not valid */
+        if (0 == field->did[idx]) { /* a fluid node is not valid */
             continue;
         }
-        if (did != node[idx].did) { /* a heterogeneous node on the path */
-            AddColObject(path[n], node[idx].did, geo);
+        if (did != field->did[idx]) { /* a heterogeneous node on the path */
+            AddColObject(path[n], field->did[idx], geo);
         }
     }
     return;
@@ -377,13 +518,43 @@ static void AddColObject(const int N[restrict], const int did, Geometry *const g
     ++(geo->colN);
     return;
 }
+/*
+ * Collision lists detected by each partition are merged in the order of
+ * geometry identifiers, and the lines of impact of the same object are
+ * accumulated as if the list were detected on the entire domain.
+ */
+static void MergeColObject(Real list[], const Partition *const part, Geometry *const geo)
+{
+    Collision *col = NULL;
+    memset(list, 0, geo->totN * (DIMS + 1) * sizeof(*list));
+    for (int n = 0; n < geo->colN; ++n) {
+        col = geo->col + n;
+        list[(col->gid - 1) * (DIMS + 1)] = 1.0;
+        list[(col->gid - 1) * (DIMS + 1) + 1] = col->N[X];
+        list[(col->gid - 1) * (DIMS + 1) + 2] = col->N[Y];
+        list[(col->gid - 1) * (DIMS + 1) + 3] = col->N[Z];
+    }
+    ReduceSum(geo->totN * (DIMS + 1), list, part);
+    geo->colN = 0;
+    for (int n = 0; n < geo->totN; ++n) {
+        if (0.0 == list[n * (DIMS + 1)]) {
+            continue;
+        }
+        col = geo->col + geo->colN;
+        col->gid = n + 1;
+        col->N[X] = (int)list[n * (DIMS + 1) + 1];
+        col->N[Y] = (int)list[n * (DIMS + 1) + 2];
+        col->N[Z] = (int)list[n * (DIMS + 1) + 3];
+        ++(geo->colN);
+    }
+    return;
+}
 static void ApplyMotion(const Real dt, Space *space)
 {
     Geometry *const geo = &(space->geo);
     Polyhedron *poly = NULL;
     RealVec offset = {0.0}; /* translation */
     RealVec angle = {0.0}; /* rotation */
-    const RealVec scale = {1.0, 1.0, 1.0}; /* scale */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (1 == poly->state) { /* stationary object */
@@ -394,6 +565,11 @@ static void ApplyMotion(const Real dt, Space *space)
             offset[s] = poly->V[TN][s] * dt;
             angle[s] = poly->W[TN][s] * dt;
         }
+        /* drift of the surface, where rotation does not move an analytical surface */
+        poly->drift = poly->drift + Norm(offset);
+        if (0 < poly->faceN) {
+            poly->drift = poly->drift + Norm(angle) * poly->r;
+        }
         /* transform geometry */
         if (0 >= poly->faceN) { /* analytical polyhedron */
             poly->O[X] = poly->O[X] + offset[X];
@@ -405,7 +581,7 @@ static void ApplyMotion(const Real dt, Space *space)
                 poly->box[s][MAX] = poly->O[s] + poly->r;
             }
         } else { /* triangulated polyhedron */
-            TransformPolyhedron(poly->O, scale, angle, offset, poly);
+            TransformPolyhedron(poly->O, angle, offset, poly);
         }
     }
     return;
@@ -19,7 +19,9 @@
 #include "fluid_dynamics.h"
 #include "solid_dynamics.h"
 #include "data_stream.h"
+#include "message_passing.h"
 #include "timer.h"
+#include "roofline.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -62,9 +64,26 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
     /* time instants interval and recorder */
     const Real tmInt = (INT_MAX == time->dataW[PROSD]) ? time->end : dtData[PROSD]; /* a specific instant */
     Real rcInt = zero; /* time instant recorder */
+    /* region timers and the optional per-step trace */
+    FILE *trace = NULL;
+    if ((0 != time->trace) && (0 == space->part.rank)) {
+        trace = Fopen("artracfd.timer.trace.csv", "w");
+        WriteRegionTraceHeader(trace);
+    }
+    if ((0 != time->counter) && (0 == space->part.rank) && (0 == OpenRegionCounter())) {
+        ShowWarning("  hardware counters not permitted, regions are timed only");
+    }
+    if ((0 != time->roofline) && (0 == space->part.rank)) {
+        ShowInfo("  measuring machine roof...\n");
+        MeasureRoof(model->isa);
+    }
+    ResetRegion();
     while ((time->now < time->end) && (time->stepC < time->stepN)) {
         ++(time->stepC);
+        StartRegion(RGSTEP);
+        StartRegion(RGDT);
         dt = ComputeTimeStep(time, space, model);
+        StopRegion(RGDT);
         if (rcInt + dt > tmInt) { /* rectify dt */
             dt = tmInt - rcInt;
             rcInt = zero;
@@ -80,17 +99,25 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
                 time->stepC, time->now, time->end - time->now, dt);
         TickTime(&tm);
         if (0 != model->psi) {
+            StartRegion(RGSOLID);
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
+            StopRegion(RGSOLID);
         }
+        StartRegion(RGFLUID);
         EvolveFluidDynamics(dt, space, model);
+        StopRegion(RGFLUID);
         if (0 != model->psi) {
+            StartRegion(RGSOLID);
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
+            StopRegion(RGSOLID);
         }
         ShowInfo("  elapsed: %.6gs\n", TockTime(&tm));
         /* export data if accumulated time increases to anticipated interval */
+        StartRegion(RGWRITE);
         for (int n = 0; n < NPROBE; ++n) {
             rcData[n] = rcData[n] + dt;
             if ((rcData[n] >= dtData[n]) || (time->now == time->end) || (time->stepC == time->stepN)) {
+                StartRegion(RGPROBE + n);
                 if (PROFC == n) {
                     IntegrateSurfaceForce(space, model);
                 }
@@ -100,21 +127,30 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
                 }
                 WriteData(n, time, space, model);
                 rcData[n] = zero; /* reset probe accumulated time */
+                StopRegion(RGPROBE + n);
             }
         }
+        StopRegion(RGWRITE);
+        StopRegion(RGSTEP);
+        CloseStepRegion(trace);
+    }
+    if (NULL != trace) {
+        fclose(trace);
+    }
+    if (0 == space->part.rank) {
+        WriteRegionReport("artracfd.timer");
+        CloseRegionCounter();
+        WriteRooflineReport("artracfd.roofline");
+        ShowInfo("  timing report written to artracfd.timer.csv\n");
     }
     return;
 }
 static Real ComputeTimeStep(const Time *time, const Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
-    const Real *restrict U = NULL;
-    Real Uo[DIMUo] = {0.0};
-    int idx = 0; /* linear array index math variable */
-    Real c = 0.0; /* speed of sound */
     RealVec V = {0.0}; /* characteristic speeds in each direction */
     RealVec Vmax = {0.0}; /* maximum characteristic speeds in each direction */
     /* incorporate solid dynamics into CFL condition */
@@ -129,26 +165,34 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
             }
         }
     }
-    /* incorporate fluid dynamics into CFL condition */
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
-                if (0 != node[idx].did) {
-                    continue;
-                }
-                MapPrimitive(model->gamma, model->gasR, U, Uo);
-                c = sqrt(model->gamma * model->gasR * Uo[5]);
-                for (int s = 0; s < DIMS; ++s) {
-                    V[s] = fabs(Uo[s+1]) + c;
-                    if (Vmax[s] < V[s]) {
-                        Vmax[s] = V[s];
+    /* incorporate fluid dynamics into CFL condition over the fluid spans along x */
+    const Run *const run = field->run + X;
+    const int jM = part->np[X][Y][MIN];
+    const int jN = part->np[X][Y][MAX];
+    const int kM = part->np[X][Z][MIN];
+    #pragma omp parallel for collapse(2) schedule(static) reduction(max:Vmax[:DIMS])
+    for (int k = kM; k < part->np[X][Z][MAX]; ++k) {
+        for (int j = jM; j < jN; ++j) {
+            const int pen = (k - kM) * (jN - jM) + (j - jM);
+            for (int q = run->head[pen]; q < run->head[pen+1]; ++q) {
+                for (int i = run->span[q][MIN]; i < run->span[q][MAX]; ++i) {
+                    const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    Real U[DIMU] = {0.0};
+                    Real Uo[DIMUo] = {0.0};
+                    GatherU(idx, field->U[TO], U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uo);
+                    const Real c = sqrt(model->gamma * model->gasR * Uo[5]); /* speed of sound */
+                    for (int s = 0; s < DIMS; ++s) {
+                        const Real Vs = fabs(Uo[s+1]) + c; /* characteristic speed */
+                        if (Vmax[s] < Vs) {
+                            Vmax[s] = Vs;
+                        }
                     }
                 }
             }
         }
     }
+    ReduceMax(DIMS, Vmax, part);
     return time->numCFL * MinReal(part->d[X] / Vmax[X], MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z]));
 }
 /* a good practice: end file with a newline */
@@ -19,7 +19,7 @@
  * Function definitions
  ****************************************************************************/
 void ComputePhi(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Node *const node,
+        const int partn[restrict], const Field *const field,
         const Model *model, Real Phi[restrict])
 {
     if (0 == model->sState) {
@@ -27,7 +27,8 @@ void ComputePhi(const int tn, const int k, const int j, const int i,
         return;
     }
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const Real *restrict U = node[idx].U[tn];
+    Real U[DIMU] = {0.0};
+    GatherU(idx, field->U[tn], U);
     const RealVec V = {U[1] / U[0], U[2] / U[0], U[3] / U[0]};
     const RealVec fb = {U[0] * model->g[X], U[0] * model->g[Y], U[0] * model->g[Z]};
     Phi[0] = 0.0;
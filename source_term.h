@@ -30,7 +30,7 @@
  *      Compute the source term.
  */
 void ComputePhi(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Node *const,
+        const int partn[restrict], const Field *const,
         const Model *, Real Phi[restrict]);
 #endif
 /* a good practice: end file with a newline */
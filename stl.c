@@ -46,7 +46,7 @@ void ReadStlFile(const char *fname, Polyhedron *poly)
     Fread(header, sizeof(StlStr), 1, fp);
     Fread(&facetN, sizeof(StlLint), 1, fp);
     poly->faceN = facetN;
-    poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet));
+    poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet), MEMGEOMETRY);
     for (StlLint n = 0; n < facetN; ++n) {
         Fread(&facetData, sizeof(StlReal), 1, fp);
         poly->facet[n].N[X] = facetData;
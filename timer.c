@@ -11,8 +11,66 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#ifdef __linux__
+#define _DEFAULT_SOURCE /* expose syscall under strict standard modes */
+#endif
 #include "timer.h"
 #include <stddef.h> /* standard library for macros */
+#include <string.h> /* manipulating strings */
+#ifdef __linux__
+#include <unistd.h> /* syscall, read, close */
+#include <sys/ioctl.h> /* control of counter devices */
+#include <sys/syscall.h> /* system call numbers */
+#include <linux/perf_event.h> /* hardware performance counters */
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h> /* processor identification */
+#endif
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Hardware counter events of a region
+ */
+typedef enum {
+    CNCYCLE = 0, /* core cycles */
+    CNINSTR = 1, /* retired instructions */
+    CNLLC = 2, /* last level cache misses */
+    CNBRANCH = 3, /* branch mispredictions */
+    CNSCALAR = 4, /* scalar double precision floating point operations */
+    CNVECTOR = 5, /* packed double precision floating point operations */
+    CNN = 6, /* number of events */
+} CounterEvent;
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char *const regionName[RGN] = {
+    "step", "dt", "solid", "force", "kinematics", "collision", "motion",
+    "geofield", "ibm", "fluid", "sweepx", "sweepy", "sweepz", "boundary",
+    "write", "point", "line", "curve", "surface", "space"};
+static const int regionParent[RGN] = { /* -1 for the root region */
+    -1, RGSTEP, RGSTEP, RGSOLID, RGSOLID, RGSOLID, RGSOLID,
+    RGSOLID, RGSOLID, RGSTEP, RGFLUID, RGFLUID, RGFLUID, RGFLUID,
+    RGSTEP, RGWRITE, RGWRITE, RGWRITE, RGWRITE, RGWRITE};
+static Timer regionStart[RGN]; /* start moment of each region */
+static double stepTime[RGN] = {0.0}; /* accumulated time in current step */
+static double runTime[RGN] = {0.0}; /* accumulated time over the run */
+static double maxTime[RGN] = {0.0}; /* maximum time of a step */
+static long callN[RGN] = {0}; /* number of region calls */
+static int stepN = 0; /* number of closed steps */
+static int counterFd[CNN] = {-1, -1, -1, -1, -1, -1}; /* event descriptors */
+static unsigned long long counterId[CNN] = {0}; /* event identifiers */
+static int counterN = 0; /* number of opened events */
+static double counterStart[RGN][CNN]; /* counts at the start of each region */
+static double counterRun[RGN][CNN]; /* accumulated counts over the run */
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+#ifdef __linux__
+static int CountFloatEvent(void);
+#endif
+static void ReadCounter(double count[]);
+static void ComputeCounterMetric(const double count[], double metric[]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -33,5 +91,263 @@ double TockTime(const Timer *tm)
     return (double)(tc.tv_sec - tm->tv_sec) +
         (double)(tc.tv_usec - tm->tv_usec) / 1000000.0;
 }
+void ResetRegion(void)
+{
+    memset(stepTime, 0, sizeof stepTime);
+    memset(runTime, 0, sizeof runTime);
+    memset(maxTime, 0, sizeof maxTime);
+    memset(callN, 0, sizeof callN);
+    memset(counterRun, 0, sizeof counterRun);
+    stepN = 0;
+    return;
+}
+void StartRegion(const int r)
+{
+    if (0 < counterN) {
+        ReadCounter(counterStart[r]);
+    }
+    TickTime(regionStart + r);
+    return;
+}
+void StopRegion(const int r)
+{
+    stepTime[r] = stepTime[r] + TockTime(regionStart + r);
+    ++callN[r];
+    if (0 < counterN) {
+        double count[CNN] = {0.0};
+        ReadCounter(count);
+        for (int n = 0; n < CNN; ++n) {
+            counterRun[r][n] = counterRun[r][n] + count[n] - counterStart[r][n];
+        }
+    }
+    return;
+}
+/*
+ * The events are opened as one group led by the cycle counter so that they
+ * are scheduled together and their ratios are consistent. Counting follows
+ * the calling thread only, which is the master thread that times regions.
+ * The floating point events are model specific raw events and are only
+ * requested when CountFloatEvent confirms their encoding; events the
+ * processor or the kernel refuses are skipped, and no counter is used if
+ * the leader can not be opened.
+ */
+int OpenRegionCounter(void)
+{
+#ifdef __linux__
+    if (0 < counterN) {
+        return counterN;
+    }
+    const unsigned long long event[CNN][2] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_RAW, 0x01C7}, /* fp_arith_inst_retired.scalar_double */
+        {PERF_TYPE_RAW, 0x54C7}, /* fp_arith_inst_retired.128b, 256b, 512b packed_double */
+    };
+    const int eventN = (0 != CountFloatEvent()) ? CNN : CNSCALAR;
+    struct perf_event_attr attr;
+    for (int n = 0; n < eventN; ++n) {
+        memset(&attr, 0, sizeof attr);
+        attr.size = sizeof attr;
+        attr.type = (unsigned int)event[n][0];
+        attr.config = event[n][1];
+        attr.disabled = (CNCYCLE == n) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        counterFd[n] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, counterFd[CNCYCLE], 0);
+        if (0 > counterFd[n]) {
+            if (CNCYCLE == n) {
+                return 0;
+            }
+            continue;
+        }
+        ioctl(counterFd[n], PERF_EVENT_IOC_ID, counterId + n);
+        ++counterN;
+    }
+    ioctl(counterFd[CNCYCLE], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counterFd[CNCYCLE], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return counterN;
+#else
+    return 0;
+#endif
+}
+void CloseRegionCounter(void)
+{
+#ifdef __linux__
+    for (int n = CNN - 1; 0 <= n; --n) {
+        if (0 <= counterFd[n]) {
+            close(counterFd[n]);
+            counterFd[n] = -1;
+        }
+    }
+#endif
+    counterN = 0;
+    return;
+}
+#ifdef __linux__
+/*
+ * The raw codes of the floating point events are those of the
+ * fp_arith_inst_retired event of Intel processors with architectural
+ * performance monitoring version 4 or later. Other vendors and older Intel
+ * processors assign other events to these codes, so their counts would be
+ * wrong rather than missing; the vendor string and the version are read by
+ * CPUID to exclude them.
+ */
+static int CountFloatEvent(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (0 == __get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    /* vendor string GenuineIntel is stored in ebx, edx, ecx */
+    if ((0x756E6547 != ebx) || (0x49656E69 != edx) || (0x6C65746E != ecx) || (0xA > eax)) {
+        return 0;
+    }
+    __cpuid(0xA, eax, ebx, ecx, edx);
+    if (4 > (eax & 0xFF)) { /* architectural performance monitoring version */
+        return 0;
+    }
+    return 1;
+#else
+    return 0;
+#endif
+}
+#endif
+/*
+ * A group read returns the event number, the enabled and running times, and
+ * a value and identifier pair per event. Counts are scaled by the share of
+ * time the group was running to account for multiplexing.
+ */
+static void ReadCounter(double count[])
+{
+#ifdef __linux__
+    unsigned long long buffer[3 + 2 * CNN] = {0};
+    if (0 >= read(counterFd[CNCYCLE], buffer, sizeof buffer)) {
+        return;
+    }
+    const double scale = (0 == buffer[2]) ? 0.0 : (double)buffer[1] / (double)buffer[2];
+    for (unsigned long long m = 0; (m < buffer[0]) && (m < CNN); ++m) {
+        for (int n = 0; n < CNN; ++n) {
+            if ((0 <= counterFd[n]) && (counterId[n] == buffer[4 + 2 * m])) {
+                count[n] = scale * (double)buffer[3 + 2 * m];
+            }
+        }
+    }
+#else
+    (void)count;
+#endif
+    return;
+}
+void CloseStepRegion(FILE *trace)
+{
+    ++stepN;
+    if (NULL != trace) {
+        fprintf(trace, "%d", stepN);
+    }
+    for (int r = 0; r < RGN; ++r) {
+        runTime[r] = runTime[r] + stepTime[r];
+        if (maxTime[r] < stepTime[r]) {
+            maxTime[r] = stepTime[r];
+        }
+        if (NULL != trace) {
+            fprintf(trace, ", %.6g", stepTime[r]);
+        }
+        stepTime[r] = 0.0;
+    }
+    if (NULL != trace) {
+        fprintf(trace, "\n");
+    }
+    return;
+}
+void WriteRegionTraceHeader(FILE *trace)
+{
+    fprintf(trace, "# step");
+    for (int r = 0; r < RGN; ++r) {
+        fprintf(trace, ", %s", regionName[r]);
+    }
+    fprintf(trace, "\n");
+    return;
+}
+/*
+ * Derived metrics: instructions per cycle, cache and branch misses per kilo
+ * instructions, and the share of packed operations in floating point
+ * operations, which is -1 when the floating point events are unavailable.
+ */
+static void ComputeCounterMetric(const double count[], double metric[])
+{
+    const double cycle = (0.0 < count[CNCYCLE]) ? count[CNCYCLE] : 1.0;
+    const double kilo = (0.0 < count[CNINSTR]) ? count[CNINSTR] / 1000.0 : 1.0;
+    const double flop = count[CNSCALAR] + count[CNVECTOR];
+    metric[0] = count[CNINSTR] / cycle;
+    metric[1] = count[CNLLC] / kilo;
+    metric[2] = count[CNBRANCH] / kilo;
+    metric[3] = (0 > counterFd[CNVECTOR]) ? -1.0 : ((0.0 < flop) ? count[CNVECTOR] / flop : 0.0);
+    return;
+}
+/*
+ * Regions are reported by their paths in the hierarchy, with the time over
+ * the run, the mean and maximum time per step, and the share of step time.
+ * Counter totals and derived metrics are appended when counters are open.
+ */
+void WriteRegionReport(const char *bname)
+{
+    char path[RGN][64] = {{'\0'}}; /* region paths */
+    char fname[256] = {'\0'};
+    double metric[4] = {0.0}; /* derived counter metrics of a region */
+    for (int r = 0; r < RGN; ++r) { /* parents always precede children */
+        if (0 > regionParent[r]) {
+            snprintf(path[r], sizeof path[r], "%s", regionName[r]);
+        } else {
+            snprintf(path[r], sizeof path[r], "%s/%s", path[regionParent[r]], regionName[r]);
+        }
+    }
+    const double total = (0.0 < runTime[RGSTEP]) ? runTime[RGSTEP] : 1.0;
+    const int steps = (0 < stepN) ? stepN : 1;
+    snprintf(fname, sizeof fname, "%s.csv", bname);
+    FILE *fp = fopen(fname, "w");
+    if (NULL != fp) {
+        fprintf(fp, "# region, calls, total, mean per step, max per step, percent of step");
+        if (0 < counterN) {
+            fprintf(fp, ", cycles, instructions, ipc, llc mpki, branch mpki, vector share");
+        }
+        fprintf(fp, "\n");
+        for (int r = 0; r < RGN; ++r) {
+            fprintf(fp, "%s, %ld, %.6g, %.6g, %.6g, %.4g", path[r], callN[r], runTime[r],
+                    runTime[r] / steps, maxTime[r], 100.0 * runTime[r] / total);
+            if (0 < counterN) {
+                ComputeCounterMetric(counterRun[r], metric);
+                fprintf(fp, ", %.6g, %.6g, %.4g, %.4g, %.4g, %.4g", counterRun[r][CNCYCLE],
+                        counterRun[r][CNINSTR], metric[0], metric[1], metric[2], metric[3]);
+            }
+            fprintf(fp, "\n");
+        }
+        fclose(fp);
+    }
+    snprintf(fname, sizeof fname, "%s.json", bname);
+    fp = fopen(fname, "w");
+    if (NULL != fp) {
+        fprintf(fp, "{\n  \"steps\": %d,\n  \"regions\": [\n", stepN);
+        for (int r = 0; r < RGN; ++r) {
+            fprintf(fp, "    {\"region\": \"%s\", \"calls\": %ld, \"total\": %.6g, \"mean\": %.6g, "
+                    "\"max\": %.6g, \"percent\": %.4g", path[r], callN[r], runTime[r],
+                    runTime[r] / steps, maxTime[r], 100.0 * runTime[r] / total);
+            if (0 < counterN) {
+                ComputeCounterMetric(counterRun[r], metric);
+                fprintf(fp, ", \"cycles\": %.6g, \"instructions\": %.6g, \"ipc\": %.4g, "
+                        "\"llc_mpki\": %.4g, \"branch_mpki\": %.4g, \"vector_share\": %.4g",
+                        counterRun[r][CNCYCLE], counterRun[r][CNINSTR], metric[0], metric[1],
+                        metric[2], metric[3]);
+            }
+            fprintf(fp, "}%s\n", (RGN - 1 == r) ? "" : ",");
+        }
+        fprintf(fp, "  ]\n}\n");
+        fclose(fp);
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
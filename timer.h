@@ -16,11 +16,37 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
 #include <sys/time.h> /* system time */
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
 typedef struct timeval Timer;
+/*
+ * Timed regions of a time step. Regions are nested as
+ *   step: time step size, solid dynamics, fluid dynamics, data writing
+ *   solid dynamics: force, kinematics, collision, motion, geometric field, ibm
+ *   fluid dynamics: sweeps in x, y, z, boundary treatment
+ *   data writing: point, line, curve, force, space probes
+ * The probe regions follow the order of the probe types.
+ */
+typedef enum {
+    RGSTEP = 0, /* time step */
+    RGDT = 1, /* time step size */
+    RGSOLID = 2, /* solid dynamics */
+    RGFORCE = 3, /* surface force integration */
+    RGKINEMATICS = 4, /* kinematics */
+    RGCOLLISION = 5, /* collision */
+    RGMOTION = 6, /* motion */
+    RGGEOFIELD = 7, /* geometric field */
+    RGIBM = 8, /* immersed boundary of moved solids */
+    RGFLUID = 9, /* fluid dynamics */
+    RGSWEEP = 10, /* sweeps in x, y, z */
+    RGBOUNDARY = 13, /* boundary treatment */
+    RGWRITE = 14, /* data writing */
+    RGPROBE = 15, /* point, line, curve, force, space probes */
+    RGN = 20, /* number of regions */
+} TimerRegion;
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -32,6 +58,43 @@ extern void TickTime(Timer *tm);
  * Tock the timer
  */
 extern double TockTime(const Timer *tm);
+/*
+ * Region timers
+ *
+ * Function
+ *      Accumulate the wall time of a region between its start and stop.
+ *      Region times are accumulated per step and over the run; closing a
+ *      step adds its times to the run and appends them to the trace file
+ *      if one is given. Regions are only timed by the master thread.
+ */
+extern void ResetRegion(void);
+extern void StartRegion(const int r);
+extern void StopRegion(const int r);
+extern void CloseStepRegion(FILE *trace);
+/*
+ * Region hardware counters
+ *
+ * Function
+ *      Open Linux performance counters for cycles, instructions, last level
+ *      cache misses, branch misses, and scalar and packed double precision
+ *      floating point operations on Intel processors with architectural
+ *      performance monitoring version 4 or later. Once opened, the counts
+ *      of the master thread are accumulated per region along with the time.
+ * Returns
+ *      the number of opened events, zero if counters are not permitted or
+ *      not supported, in which case regions are timed only.
+ */
+extern int OpenRegionCounter(void);
+extern void CloseRegionCounter(void);
+/*
+ * Region timing report
+ *
+ * Function
+ *      Write the header of a trace file, and write the run report of all
+ *      regions as bname.csv and bname.json.
+ */
+extern void WriteRegionTraceHeader(FILE *trace);
+extern void WriteRegionReport(const char *bname);
 #endif
 /* a good practice: end file with a newline */
 
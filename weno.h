@@ -20,6 +20,10 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef enum {
+    WENOBATCH = 8, /* maximum number of interfaces in a batch */
+    WENOLANE = 2 * DIMU * WENOBATCH, /* maximum number of characteristic fields in a batch */
+} WENOConstBatch;
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -31,6 +35,17 @@
  */
 extern void WENO3(Real F[restrict][DIMU], Real Fhat[restrict]);
 extern void WENO5(Real F[restrict][DIMU], Real Fhat[restrict]);
+/*
+ * Batched WENO
+ *
+ * Function
+ *      Reconstruct a batch of characteristic fields, one field per lane.
+ *      Stencil values are stored as F[stencil node][lane]. The code path of
+ *      the instruction set isa is used, and results are bitwise identical
+ *      to the unbatched reconstruction.
+ */
+extern void WENO3Batch(const int isa, const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict]);
+extern void WENO5Batch(const int isa, const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
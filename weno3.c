@@ -21,10 +21,34 @@ typedef enum {
     R = 2, /* WENO r */
     CN = 1, /* position index of the center node in stencil */
 } WENOConst;
+/****************************************************************************
+ * Function Pointers
+ ****************************************************************************/
+typedef void (*LaneReconstructor)(const int, Real [restrict][WENOLANE], Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static Real Square(const Real);
+static void WENO3Lanes(const int, Real [restrict][WENOLANE], Real [restrict]);
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void WENO3LanesAVX2(const int, Real [restrict][WENOLANE], Real [restrict]);
+TARGET("avx512f") static void WENO3LanesAVX512(const int, Real [restrict][WENOLANE], Real [restrict]);
+#endif
+KERNEL void WENO3Kernel(const int, Real [restrict][WENOLANE], Real [restrict]);
+KERNEL Real Square(const Real);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+#ifdef ARTRACFD_X86
+static LaneReconstructor ReconstructLanes[3] = {
+    WENO3Lanes,
+    WENO3LanesAVX2,
+    WENO3LanesAVX512};
+#else
+static LaneReconstructor ReconstructLanes[3] = {
+    WENO3Lanes,
+    WENO3Lanes,
+    WENO3Lanes};
+#endif
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -53,7 +77,55 @@ void WENO3(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
-static Real Square(const Real x)
+void WENO3Batch(const int isa, const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    ReconstructLanes[isa](laneN, F, Fhat);
+    return;
+}
+static void WENO3Lanes(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO3Kernel(laneN, F, Fhat);
+    return;
+}
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void WENO3LanesAVX2(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO3Kernel(laneN, F, Fhat);
+    return;
+}
+TARGET("avx512f") static void WENO3LanesAVX512(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO3Kernel(laneN, F, Fhat);
+    return;
+}
+#endif
+/*
+ * The lane loop repeats the arithmetic of the unbatched reconstruction
+ * operation by operation, therefore vector lanes round identically.
+ */
+KERNEL void WENO3Kernel(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    const Real C[R] = {1.0 / 3.0, 2.0 / 3.0};
+    const Real epsilon = 1.0e-6;
+    #pragma omp simd
+    for (int l = 0; l < laneN; ++l) {
+        Real omega[R]; /* weights */
+        Real q[R]; /* q vectors */
+        Real IS[R]; /* smoothness measurements */
+        Real alpha[R];
+        IS[0] = Square(F[CN][l] - F[CN-1][l]);
+        IS[1] = Square(F[CN+1][l] - F[CN][l]);
+        alpha[0] = C[0] / Square(epsilon + IS[0]);
+        alpha[1] = C[1] / Square(epsilon + IS[1]);
+        omega[0] = alpha[0] / (alpha[0] + alpha[1]);
+        omega[1] = alpha[1] / (alpha[0] + alpha[1]);
+        q[0] = (1.0 / 2.0) * (-F[CN-1][l] + 3.0 * F[CN][l]);
+        q[1] = (1.0 / 2.0) * (F[CN][l] + F[CN+1][l]);
+        Fhat[l] = omega[0] * q[0] + omega[1] * q[1];
+    }
+    return;
+}
+KERNEL Real Square(const Real x)
 {
     return x * x;
 }
@@ -21,10 +21,34 @@ typedef enum {
     R = 3, /* WENO r */
     CN = 2, /* position index of the center node in stencil */
 } WENOConst;
+/****************************************************************************
+ * Function Pointers
+ ****************************************************************************/
+typedef void (*LaneReconstructor)(const int, Real [restrict][WENOLANE], Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static Real Square(const Real);
+static void WENO5Lanes(const int, Real [restrict][WENOLANE], Real [restrict]);
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void WENO5LanesAVX2(const int, Real [restrict][WENOLANE], Real [restrict]);
+TARGET("avx512f") static void WENO5LanesAVX512(const int, Real [restrict][WENOLANE], Real [restrict]);
+#endif
+KERNEL void WENO5Kernel(const int, Real [restrict][WENOLANE], Real [restrict]);
+KERNEL Real Square(const Real);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+#ifdef ARTRACFD_X86
+static LaneReconstructor ReconstructLanes[3] = {
+    WENO5Lanes,
+    WENO5LanesAVX2,
+    WENO5LanesAVX512};
+#else
+static LaneReconstructor ReconstructLanes[3] = {
+    WENO5Lanes,
+    WENO5Lanes,
+    WENO5Lanes};
+#endif
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -60,7 +84,62 @@ void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
-static Real Square(const Real x)
+void WENO5Batch(const int isa, const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    ReconstructLanes[isa](laneN, F, Fhat);
+    return;
+}
+static void WENO5Lanes(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO5Kernel(laneN, F, Fhat);
+    return;
+}
+#ifdef ARTRACFD_X86
+TARGET("avx2") static void WENO5LanesAVX2(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO5Kernel(laneN, F, Fhat);
+    return;
+}
+TARGET("avx512f") static void WENO5LanesAVX512(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    WENO5Kernel(laneN, F, Fhat);
+    return;
+}
+#endif
+/*
+ * The lane loop repeats the arithmetic of the unbatched reconstruction
+ * operation by operation, therefore vector lanes round identically.
+ */
+KERNEL void WENO5Kernel(const int laneN, Real F[restrict][WENOLANE], Real Fhat[restrict])
+{
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-6;
+    #pragma omp simd
+    for (int l = 0; l < laneN; ++l) {
+        Real omega[R]; /* weights */
+        Real q[R]; /* q vectors */
+        Real IS[R]; /* smoothness measurements */
+        Real alpha[R];
+        IS[0] = (13.0 / 12.0) * Square(F[CN-2][l] - 2.0 * F[CN-1][l] + F[CN][l]) +
+            (1.0 / 4.0) * Square(F[CN-2][l] - 4.0 * F[CN-1][l] + 3.0 * F[CN][l]);
+        IS[1] = (13.0 / 12.0) * Square(F[CN-1][l] - 2.0 * F[CN][l] + F[CN+1][l]) +
+            (1.0 / 4.0) * Square(F[CN-1][l] - F[CN+1][l]);
+        IS[2] = (13.0 / 12.0) * Square(F[CN][l] - 2.0 * F[CN+1][l] + F[CN+2][l]) +
+            (1.0 / 4.0) * Square(3.0 * F[CN][l] - 4.0 * F[CN+1][l] + F[CN+2][l]);
+        alpha[0] = C[0] / Square(epsilon + IS[0]);
+        alpha[1] = C[1] / Square(epsilon + IS[1]);
+        alpha[2] = C[2] / Square(epsilon + IS[2]);
+        omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+        omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+        omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+        q[0] = (1.0 / 6.0) * (2.0 * F[CN-2][l] - 7.0 * F[CN-1][l] + 11.0 * F[CN][l]);
+        q[1] = (1.0 / 6.0) * (-F[CN-1][l] + 5.0 * F[CN][l] + 2.0 * F[CN+1][l]);
+        q[2] = (1.0 / 6.0) * (2.0 * F[CN][l] + 5.0 * F[CN+1][l] - F[CN+2][l]);
+        Fhat[l] = omega[0] * q[0] + omega[1] * q[1] + omega[2] * q[2];
+    }
+    return;
+}
+KERNEL Real Square(const Real x)
 {
     return x * x;
 }